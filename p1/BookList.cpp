@@ -4,9 +4,11 @@
 // PURPOSE: This file contains the implementation of methods to manage a list of books.
 // INPUT:   The addBook method takes details of a new book (author, title, year, and user ID)
 // as input to add it to the list.
-// PROCESS: The resizeArray method increases the capacity of the book array when it's full,ensuring space
-// for more books. getBookArray returns the book array pointer for accessing and modifying book data.
-// addBook checks if there's room to add a new book. If not, it expands the array first using resizeArray.
+// PROCESS: addBook appends the new book to the book columns, which double their capacity when they are
+// full. The ISBN is the book's position in the list plus one. A book's key is hashed (64-bit FNV-1a) over
+// the normalized author and title and the year, and the book goes in the key table under that hash. A
+// hash match is confirmed by comparing the normalized fields. Books with the same author, title and year
+// strings share their pooled handles, so most matches need no normalizing at all.
 // OUTPUT:  The methods here manipulate the book array to facilitate book management, but they don't directly
 // produce any output.
 
@@ -14,57 +16,115 @@
 #include<string>
 
 #include "BookList.h"
+#include "Fnv.h"
 using namespace std;
 
 
-// Method to resize the book array when it reaches capacity
-void BookList::resizeArray(){
+// Method to lower-case a text, drop apostrophes and turn every run of other characters into one space
+string BookList::normalize(PooledString text){
+    string key;
+    const char* s = text.data();
+    for(size_t i = 0 ; i<text.size() ; i++){
+        char c = s[i];
+        if(c >= 'A' && c <= 'Z'){
+            c = c - 'A' + 'a';
+        }
+        if((c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || (c & 0x80)){
+            key += c;
+        }
+
+        // An apostrophe joins the two halves of the word ("Hitchhiker's" is "hitchhikers")
+        else if(c != '\'' && !key.empty() && key.back() != ' '){
+            key += ' ';
+        }
+    }
+    if(!key.empty() && key.back() == ' '){
+        key.pop_back();
+    }
+    return key;
+}
 
-    // Allocate a new array with double the capacity
-    Book* copyArray = new Book[2*capacity];
+// Method to add the normalized bytes of a text to a hash, without building the normalized text
+uint64_t BookList::hashWords(uint64_t hash, PooledString text){
+    const char* s = text.data();
+    bool started = false;
+    bool space = false;
+    for(size_t i = 0 ; i<text.size() ; i++){
+        char c = s[i];
+        if(c >= 'A' && c <= 'Z'){
+            c = c - 'A' + 'a';
+        }
+        if((c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || (c & 0x80)){
+
+            // A run of other characters is one space, and only between two words
+            if(space){
+                hash = hashByte(hash, ' ');
+                space = false;
+            }
+            hash = hashByte(hash, (uint8_t)c);
+            started = true;
+        }
+        else if(c != '\''){
+            space = started;
+        }
+    }
+    return hash;
+}
 
-    // Update the capacity
-    capacity = 2*capacity;
+// Method to get the hash of a book's key
+uint64_t BookList::keyOf(PooledString Author, PooledString Title, int Year){
+    // A zero byte goes between the fields, so words cannot move from the author to the title
+    uint64_t hash = hashByte(hashWords(FNV_OFFSET, Author), 0);
+    hash = hashByte(hashWords(hash, Title), 0);
+    return (hash ^ (uint32_t)Year) * FNV_PRIME;
+}
 
-    // Copy existing books to the new array
-    for(int i = 0 ; i<capacity/2 ;i++){
-        copyArray[i] = bookArray[i];
+// Method to check whether the book at an index has the given key
+bool BookList::sameKey(int i, PooledString Author, PooledString Title, int Year) const{
+    if(books.at<3>(i) != Year){
+        return false;
     }
-
-    // Deallocate memory for the old array and update the pointer
-    delete[] bookArray;
-    bookArray = copyArray;
+    if(books.at<1>(i) != Author && normalize(books.at<1>(i)) != normalize(Author)){
+        return false;
+    }
+    return books.at<2>(i) == Title || normalize(books.at<2>(i)) == normalize(Title);
 }
 
-// Method to get the pointer to the book array
-Book* BookList::getBookArray(){
-    return bookArray;
+// Method to replace the book at an index
+void BookList::setBook(int i, const Book& b){
+    bool rekey = books.at<1>(i) != b.Author || books.at<2>(i) != b.Title || books.at<3>(i) != b.Year;
+    if(rekey){
+        keys.erase(i);
+    }
+    books.at<0>(i) = b.ISBN;
+    books.at<1>(i) = b.Author;
+    books.at<2>(i) = b.Title;
+    books.at<3>(i) = b.Year;
+    books.at<4>(i) = b.introducer;
+    if(rekey){
+        keys.insert(i, keyOf(b.Author, b.Title, b.Year));
+    }
 }
 
 // Method to add a new book to the list
-void BookList::addBook(string Author,string Title,int Year,int loggedInUser){
-
-
-    // Check if there is enough space in the array
-    if(countBooks < capacity){
+void BookList::addBook(PooledString Author,PooledString Title,int Year,int loggedInUser){
 
-        // Create a new book object with the provided details
-        Book newBook(countBooks+1, Author, Title, Year, loggedInUser);
+    // The new book goes right after the existing ones and its ISBN follows on from theirs
+    int i = books.append(books.size()+1, Author, Title, Year, loggedInUser);
+    keys.insert(i, keyOf(Author, Title, Year));
 
-        // Add the new book to the array and update the book count
-        (this->bookArray)[countBooks] = newBook;
-        this->countBooks++;
-
-    }
-    else{
-
-        // If the array is full, resize it and then add the new book
-        this->resizeArray();
-        Book newBook(capacity+1, Author, Title, Year, loggedInUser);
-
-        // Add the new book at the end of the resized array
-        (this->bookArray)[capacity] = newBook;
-        this->countBooks++;
-    }
+}
 
+// Method to find the first book with the same author, title and year (ignoring case, spaces and
+// punctuation), returning its index or -1 if there is none
+int BookList::findBook(PooledString Author, PooledString Title, int Year) const{
+    int found = -1;
+
+    // Every book with the key was added with its hash; the lowest index is the first one
+    keys.forEach(keyOf(Author, Title, Year), [&](int i){
+        if((found < 0 || i < found) && sameKey(i, Author, Title, Year)){
+            found = i;
+        }
+    });
+    return found;
 }
@@ -0,0 +1,42 @@
+//
+// Created by Shikha Pallavi on 10/17/26.
+//
+
+#ifndef P1_FNV_H
+#define P1_FNV_H
+
+// AUTHOR: Shikha Pallavi
+// PROGRAM: Fnv.h
+// DATE: 10/17/2026
+// PURPOSE: Header file for the 64-bit FNV-1a hash, shared by the string pool, the hash index of the lists,
+// the book keys and the checksums of the change log.
+// INPUT: None directly from the user. Callers hand over bytes to hash.
+// PROCESS: Every byte is XORed into the hash, which is then multiplied by the FNV prime. hashByte adds one
+// byte, so a caller that hashes text as it normalizes it (the book keys) gets the same hash as hashing the
+// normalized bytes in one go with hashBytes.
+// OUTPUT: None directly. The functions return the hash.
+
+#include<cstddef>
+#include<cstdint>
+
+// Starting value and multiplier of the 64-bit FNV-1a hash
+#define FNV_OFFSET 14695981039346656037ULL
+#define FNV_PRIME 1099511628211ULL
+
+
+using namespace std;
+
+// Function to add one byte to a hash
+inline uint64_t hashByte(uint64_t hash, uint8_t byte){
+    return (hash ^ byte) * FNV_PRIME;
+}
+
+// Function to add n bytes to a hash (a new hash by default)
+inline uint64_t hashBytes(const char* s, size_t n, uint64_t hash = FNV_OFFSET){
+    for(size_t i = 0 ; i<n ; i++){
+        hash = hashByte(hash, (uint8_t)s[i]);
+    }
+    return hash;
+}
+
+#endif //P1_FNV_H
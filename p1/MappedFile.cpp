@@ -0,0 +1,80 @@
+
+// AUTHOR: Shikha Pallavi
+// PROGRAM: MappedFile.cpp
+// DATE: 10/16/2026
+
+// PURPOSE: This file contains the implementation of the read-only file mapping.
+
+// INPUT: open takes the path of the file to map.
+
+// PROCESS: The file is opened, its size taken with fstat and the whole file mapped private and read-only.
+// The descriptor is closed right away; the mapping stays valid until it is unmapped. The kernel is told
+// the file will be read front to back so it reads ahead aggressively.
+
+// OUTPUT: open returns whether the file could be mapped and, if not, why.
+
+#include<iostream>
+#include<string>
+#include<cstring>
+#include<sys/mman.h>
+#include<sys/stat.h>
+#include<fcntl.h>
+#include<unistd.h>
+#include "MappedFile.h"
+
+
+using namespace std;
+
+// Method to map a whole file, returning false (with a reason) if it cannot be opened
+bool MappedFile::open(string filePath, string& error){
+    close();
+    int fd = ::open(filePath.c_str(), O_RDONLY);
+    if(fd < 0){
+        error = "cannot open " + filePath;
+        return false;
+    }
+    struct stat info;
+    if(fstat(fd, &info) != 0){
+        ::close(fd);
+        error = "cannot read the size of " + filePath;
+        return false;
+    }
+    if(info.st_size == 0){
+        ::close(fd);
+        return true;
+    }
+    void* mapped = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if(mapped == MAP_FAILED){
+        error = "cannot map " + filePath;
+        return false;
+    }
+    madvise(mapped, info.st_size, MADV_SEQUENTIAL);
+    base = (const char*)mapped;
+    length = info.st_size;
+    return true;
+}
+
+// Method to count the lines of the file (a last line without a newline counts too)
+long long MappedFile::countLines() const{
+    long long lines = 0;
+    const char* p = base;
+    const char* end = base + length;
+    while(p < end && (p = (const char*)memchr(p, '\n', end - p)) != nullptr){
+        lines++;
+        p++;
+    }
+    if(length > 0 && base[length - 1] != '\n'){
+        lines++;
+    }
+    return lines;
+}
+
+// Method to unmap the file
+void MappedFile::close(){
+    if(base != nullptr){
+        munmap((void*)base, length);
+    }
+    base = nullptr;
+    length = 0;
+}
@@ -0,0 +1,65 @@
+//
+// Created by Shikha Pallavi on 10/16/26.
+//
+
+#ifndef P1_MAPPEDFILE_H
+#define P1_MAPPEDFILE_H
+
+// AUTHOR: Shikha Pallavi
+// PROGRAM: MappedFile.h
+// DATE: 10/16/2026
+// PURPOSE: Header file for a read-only memory mapping of a whole file.
+// INPUT: None directly from the user. The loaders open the files the user named.
+// PROCESS: open maps the file with mmap so its bytes can be read in place, with no read() copies and no
+// buffer management. close (or the destructor) unmaps it. An empty file opens with a null data pointer.
+// OUTPUT: None directly. The class hands out a pointer to the file's bytes and its size.
+
+#include<iostream>
+#include<string>
+#include<cstddef>
+
+
+using namespace std;
+
+// Class for mapping a file into memory for reading
+class MappedFile{
+private:
+
+    const char* base;  // Start of the mapping, or null when nothing is mapped
+    size_t length;     // Size of the file in bytes
+
+public:
+
+    // Constructor to create a mapping with nothing open
+    MappedFile(){
+        base = nullptr;
+        length = 0;
+    }
+
+    // Destructor to unmap the file
+    ~MappedFile(){
+        close();
+    }
+
+    // Method to map a whole file, returning false (with a reason) if it cannot be opened
+    bool open(string filePath, string& error);
+
+    // Method to unmap the file
+    void close();
+
+    // Method to get a pointer to the first byte of the file
+    const char* data() const{
+        return base;
+    }
+
+    // Method to get the size of the file in bytes
+    size_t size() const{
+        return length;
+    }
+
+    // Method to count the lines of the file (a last line without a newline counts too)
+    long long countLines() const;
+
+};
+
+#endif //P1_MAPPEDFILE_H
@@ -5,67 +5,80 @@
 // PURPOSE: This file contains methods to manage a list of members.
 // INPUT:The addMember method takes the name of the member and the ID of the logged-in user who added the member.
 // These parameters are used to create a new Member object and add it to the list of members.
-// PROCESS:The resizeArray method increases the capacity of the member array when it's full, ensuring space
-// for more members. getMemberArray returns the member array pointer for accessing and modifying member data.
-// addMember checks if there's room to add a new member. If not, it expands the array first using resizeArray.
+// PROCESS:addMember appends the new member to the member columns, which double their capacity when they
+// are full. The account number is the member's position in the list plus one. Every member goes in the
+// name table under the hash of its name; a lookup compares the names of the members stored under the
+// hash, so two names that collide are still told apart.
 // OUTPUT:  The methods here manipulate the member array to facilitate member management, but they don't
 // directly produce any output.
 
 #include<iostream>
 #include<string>
+#include<algorithm>
 #include "MemberList.h"
 
 
 using namespace std;
 
-// Method to resize the member array when it reaches capacity
-void MemberList::resizeArray(){
+// Method to add a new member to the list
+void MemberList::addMember(PooledString name, int loggedInUser){
 
-    // Allocate a new array with double the capacity
-    Member* copyArray = new Member[2*capacity];
+    // The new member goes right after the existing ones and the account number follows on from theirs
+    int i = members.append(name, members.size()+1, loggedInUser);
+    names.insert(i, hashBytes(name.data(), name.size()));
 
-    // Update the capacity
-    capacity = 2*capacity;
+}
 
-    // Copy existing members to the new array
-    for(int i = 0 ; i<capacity/2 ;i++){
-        copyArray[i] = memberArray[i];
+// Method to replace the member at an index
+void MemberList::setMember(int i, const Member& m){
+    if(members.at<0>(i) != m.Name){
+        names.erase(i);
+        names.insert(i, hashBytes(m.Name.data(), m.Name.size()));
     }
-
-    // Deallocate memory for the old array and update the pointer
-    delete[] memberArray;
-    memberArray = copyArray;
+    members.at<0>(i) = m.Name;
+    members.at<1>(i) = m.Account;
+    members.at<2>(i) = m.adddedBY;
 }
 
-// Method to get the pointer to the member array
-Member* MemberList::getMemberArray(){
-    return memberArray;
+// Method to find the first member with a name, returning its index (account number - 1) or -1
+int MemberList::findMember(const char* name, size_t n) const{
+    int found = -1;
+    names.forEach(hashBytes(name, n), [&](int i){
+        if((found < 0 || i < found) && sameName(i, name, n)){
+            found = i;
+        }
+    });
+    return found;
 }
 
-// Method to add a new member to the list
-void MemberList::addMember(string name, int loggedInUser){
-
-
-    // Check if there is enough space in the array
-    if(countMem < capacity){
-
-        // Create a new member object with the provided details
-        Member newMem(name, countMem+1, loggedInUser);
+// Method to put the index of every member with a name in accounts, in account order
+void MemberList::findMembers(const char* name, size_t n, vector<int>& accounts) const{
+    accounts.clear();
+    names.forEach(hashBytes(name, n), [&](int i){
+        if(sameName(i, name, n)){
+            accounts.push_back(i);
+        }
+    });
+    sort(accounts.begin(), accounts.end());
+}
 
-        // Add the new member to the array and update the member count
-        (this->memberArray)[countMem] = newMem;
-        this->countMem++;
+// Method to find many names at once, accounts[i] receiving the index of the first member called
+// wanted[i] or -1
+void MemberList::findMembers(const vector<string>& wanted, vector<int>& accounts) const{
 
+    // Every name is hashed and its slot requested first, so the table's cache misses overlap
+    vector<uint64_t> hashes(wanted.size());
+    for(size_t k = 0 ; k<wanted.size() ; k++){
+        hashes[k] = hashBytes(wanted[k].data(), wanted[k].size());
+        names.prefetch(hashes[k]);
     }
-    else{
-
-        // If the array is full, resize it and then add the new member
-        this->resizeArray();
-        Member newMem(name, capacity+1, loggedInUser);
-
-        // Add the new member at the end of the resized array
-        (this->memberArray)[capacity] = newMem;
-        this->countMem++;
+    accounts.assign(wanted.size(), -1);
+    for(size_t k = 0 ; k<wanted.size() ; k++){
+        int& found = accounts[k];
+        names.forEach(hashes[k], [&](int i){
+            if((found < 0 || i < found) && sameName(i, wanted[k].data(), wanted[k].size())){
+                found = i;
+            }
+        });
     }
-
 }
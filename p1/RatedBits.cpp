@@ -0,0 +1,106 @@
+// AUTHOR: Shikha Pallavi
+// PROGRAM: RatedBits.cpp
+// DATE: 10/16/2026
+
+// PURPOSE: This file contains the implementation of the per-member rated-book bitsets.
+
+// INPUT: coRated and unratedBy take two member ids; growMembers and growBooks take the new number of
+// members and books; set takes a member, a book and whether it is rated.
+
+// PROCESS: growMembers adds rows of empty blocks and growBooks adds empty blocks at the end of every row
+// of blocks, so growth costs one pointer per new block and never copies a word; set allocates a block
+// (zeroed) the first time a book in it is rated. coRated adds up the popcount of the AND of the two rows word by word, skipping the
+// blocks either member has none of. unratedBy computes neighbour AND NOT user one word at a time and peels off the set bits lowest first, so whole words of
+// books the neighbour never rated (or the user already rated) are skipped at once.
+
+// OUTPUT: None directly. The methods return overlap counts and candidate book lists.
+
+#include<iostream>
+#include<string>
+#include "RatedBits.h"
+
+
+using namespace std;
+
+// Destructor to free every block
+RatedBits::~RatedBits(){
+    for(vector<uint64_t*>& row : blocks){
+        for(uint64_t* block : row){
+            delete[] block;
+        }
+    }
+}
+
+// Method to add empty rows until the bitsets cover m members
+void RatedBits::growMembers(int m){
+    if(m <= members){
+        return;
+    }
+    members = m;
+    vector<uint64_t*> emptyRow(blocksFor(words, RATED_BLOCK_WORDS), nullptr);
+    blocks.resize(blocksFor(members, RATED_BLOCK_MEMBERS), emptyRow);
+}
+
+// Method to widen every row until it covers b books
+void RatedBits::growBooks(int b){
+    int needed = blocksFor(b, BITS_PER_WORD);
+    if(needed <= words){
+        return;
+    }
+    words = needed;
+    for(vector<uint64_t*>& row : blocks){
+        row.resize(blocksFor(words, RATED_BLOCK_WORDS), nullptr);
+    }
+}
+
+// Method to record whether a member has rated a book
+void RatedBits::set(int member, int book, bool rated){
+    uint64_t*& block = blocks[member / RATED_BLOCK_MEMBERS][book / (RATED_BLOCK_WORDS * BITS_PER_WORD)];
+    if(block == nullptr){
+        if(!rated){
+            return;
+        }
+        block = new uint64_t[RATED_BLOCK_MEMBERS * RATED_BLOCK_WORDS]();
+    }
+    int w = book / BITS_PER_WORD % RATED_BLOCK_WORDS;
+    uint64_t& word = block[(member % RATED_BLOCK_MEMBERS) * RATED_BLOCK_WORDS + w];
+    uint64_t bit = 1ULL << (book % BITS_PER_WORD);
+    if(rated){
+        word |= bit;
+    }
+    else{
+        word &= ~bit;
+    }
+}
+
+// Method to count the books both members rated
+int RatedBits::coRated(int a, int b) const{
+    int count = 0;
+    for(int wordBlock = 0 ; wordBlock<blocksFor(words, RATED_BLOCK_WORDS) ; wordBlock++){
+        const uint64_t* rowA = blockRow(a, wordBlock);
+        const uint64_t* rowB = blockRow(b, wordBlock);
+        if(rowA == nullptr || rowB == nullptr) continue;
+        for(int w = 0 ; w<RATED_BLOCK_WORDS ; w++){
+            count += __builtin_popcountll(rowA[w] & rowB[w]);
+        }
+    }
+    return count;
+}
+
+// Method to list, in increasing order, the books the neighbour rated and the user did not
+void RatedBits::unratedBy(int user, int neighbour, vector<int>& found) const{
+    found.clear();
+    for(int wordBlock = 0 ; wordBlock<blocksFor(words, RATED_BLOCK_WORDS) ; wordBlock++){
+        const uint64_t* neighbourRow = blockRow(neighbour, wordBlock);
+        if(neighbourRow == nullptr) continue;
+        const uint64_t* userRow = blockRow(user, wordBlock);
+        for(int w = 0 ; w<RATED_BLOCK_WORDS ; w++){
+            uint64_t candidates = neighbourRow[w] & ~(userRow ? userRow[w] : 0);
+            int first = (wordBlock * RATED_BLOCK_WORDS + w) * BITS_PER_WORD;
+            while(candidates != 0){
+                found.push_back(first + __builtin_ctzll(candidates));
+                candidates &= candidates - 1;
+            }
+        }
+    }
+}
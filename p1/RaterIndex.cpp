@@ -0,0 +1,47 @@
+
+// AUTHOR: Shikha Pallavi
+// PROGRAM: RaterIndex.cpp
+// DATE: 10/16/2026
+
+// PURPOSE: This file contains the implementation of the book-major rater index.
+
+// INPUT: The update method takes a member, a book and the member's new rating for that book.
+
+// PROCESS: update binary searches the book's rater list for the member. An existing entry is
+// overwritten or erased; a missing one is inserted at its sorted position. Loaders add members in id
+// order, so in practice inserts land at the end of the list.
+
+// OUTPUT: None directly. The method keeps the rater lists in sync with the rating map.
+
+#include<iostream>
+#include<string>
+#include<algorithm>
+#include "RaterIndex.h"
+
+
+using namespace std;
+
+// Method to record a member's rating for a book (0 removes the entry)
+void RaterIndex::update(int member, int book, int rating){
+    vector<Rater>& list = raters[book];
+
+    // Find the member's position in the sorted list
+    auto pos = lower_bound(list.begin(), list.end(), member,
+                           [](const Rater& r, int m){ return r.member < m; });
+    bool found = pos != list.end() && pos->member == member;
+
+    if(rating == 0){
+        if(found){
+            list.erase(pos);
+        }
+    }
+    else if(found){
+        pos->rating = (int8_t)rating;
+    }
+    else{
+        Rater r;
+        r.member = member;
+        r.rating = (int8_t)rating;
+        list.insert(pos, r);
+    }
+}
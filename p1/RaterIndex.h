@@ -0,0 +1,77 @@
+//
+// Created by Shikha Pallavi on 10/16/26.
+//
+
+#ifndef P1_RATERINDEX_H
+#define P1_RATERINDEX_H
+
+// AUTHOR: Shikha Pallavi
+// PROGRAM: RaterIndex.h
+// DATE: 10/16/2026
+// PURPOSE: Header file for a book-major inverted index of ratings: for every book, the members who rated it.
+// INPUT: None directly from the user. RatingList reports every rating change through update().
+// PROCESS: Each book keeps a list of (member, rating) entries sorted by member id. Setting a rating
+// inserts or overwrites the member's entry, and a rating of 0 removes it, so only rated cells are stored.
+// OUTPUT: None directly. The index lets the recommendation code visit only members who share a book.
+
+#include<iostream>
+#include<string>
+#include<vector>
+#include<cstdint>
+
+
+using namespace std;
+
+// Struct for representing one member's rating in a book's rater list
+struct Rater{
+
+    int member;      // Member ID
+    int8_t rating;   // Rating given by the member to the book
+
+};
+
+// Class for keeping, per book, the members who rated it
+class RaterIndex{
+private:
+
+    vector<vector<Rater>> raters;  // Rater list of every book, sorted by member id
+
+public:
+
+    // Constructor to create empty rater lists for the given number of books
+    RaterIndex(int b){
+        raters.resize(b);
+    }
+
+    // Method to add empty rater lists until the index covers b books
+    void growBooks(int b){
+        if(b > (int)raters.size()){
+            raters.resize(b);
+        }
+    }
+
+    // Method to record a member's rating for a book (0 removes the entry)
+    void update(int member, int book, int rating);
+
+    // Method to record a non-zero rating, appending it when the member comes after every member in the
+    // book's list (as in a bulk load, member by member) instead of searching the list
+    void add(int member, int book, int rating){
+        vector<Rater>& list = raters[book];
+        if(list.empty() || list.back().member < member){
+            Rater r;
+            r.member = member;
+            r.rating = (int8_t)rating;
+            list.push_back(r);
+            return;
+        }
+        update(member, book, rating);
+    }
+
+    // Method to get the list of members who rated a book
+    const vector<Rater>& ratersOf(int book) const{
+        return raters[book];
+    }
+
+};
+
+#endif //P1_RATERINDEX_H
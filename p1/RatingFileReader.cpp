@@ -0,0 +1,102 @@
+
+// AUTHOR: Shikha Pallavi
+// PROGRAM: RatingFileReader.cpp
+// DATE: 10/16/2026
+
+// PURPOSE: This file contains the chunking and error reporting of the ratings file reader.
+
+// INPUT: splitChunks takes the thread pool used for the read; parseChunk takes a chunk to fill; where
+// takes the line and column of a problem and a description of it.
+
+// PROCESS: The scanner itself is a template in the header so the callbacks are inlined into it.
+// splitChunks cuts the file at line starts near every READ_CHUNK_BYTES, counts the lines of every piece
+// on the pool (memchr again), and turns the counts into the line number each piece starts on. A piece
+// that starts on a ratings line (an even line number) gives that line to the piece before it, so every
+// chunk starts on a name line and the member/ratings pairing is the same as in a serial read.
+// parseChunk runs the scanner over a chunk and appends every name to the chunk's names and every
+// non-zero rating to the last member's row, so the rows come out in the compressed form RatingList's
+// bulk insert takes.
+
+// OUTPUT: The chunks to parse, and the error message available through getError().
+
+#include<iostream>
+#include<string>
+#include "RatingFileReader.h"
+
+
+using namespace std;
+
+// Method to describe a problem at a line and column of the file
+string RatingFileReader::where(int line, long long column, string message){
+    return "line " + to_string(line) + ", column " + to_string(column) + ": " + message;
+}
+
+// Method to cut the file into chunks that each start on a name line
+vector<RatingChunk> RatingFileReader::splitChunks(ThreadPool& pool){
+    const char* begin = file.data();
+    const char* end = begin + file.size();
+
+    // Cut points at the first line start at or after every READ_CHUNK_BYTES
+    vector<const char*> cuts;
+    cuts.push_back(begin);
+    for(long long offset = READ_CHUNK_BYTES ; offset < (long long)file.size() ; offset += READ_CHUNK_BYTES){
+        const char* eol = (const char*)memchr(begin + offset, '\n', end - (begin + offset));
+        if(eol == nullptr || eol + 1 >= end) break;
+        if(eol + 1 > cuts.back()){
+            cuts.push_back(eol + 1);
+        }
+    }
+    cuts.push_back(end);
+    int pieces = (int)cuts.size() - 1;
+
+    // Count the newlines of every piece in parallel
+    vector<int> newlines(pieces, 0);
+    pool.run(pieces, [&](int i){
+        const char* p = cuts[i];
+        while((p = (const char*)memchr(p, '\n', cuts[i + 1] - p)) != nullptr){
+            newlines[i]++;
+            p++;
+        }
+    });
+
+    // Line number of every cut; a cut on a ratings line moves past it
+    vector<RatingChunk> chunks;
+    int line = 1;
+    for(int i = 0 ; i<pieces ; i++){
+        const char* first = cuts[i];
+        int firstLine = line;
+        if(firstLine % 2 == 0){
+            const char* eol = (const char*)memchr(first, '\n', end - first);
+            first = (eol == nullptr) ? end : eol + 1;
+            firstLine++;
+        }
+        line += newlines[i];
+        if(first >= cuts[i + 1] && i + 1 < pieces){
+            continue;
+        }
+        if(!chunks.empty()){
+            chunks.back().last = first;
+        }
+        RatingChunk chunk;
+        chunk.first = first;
+        chunk.last = end;
+        chunk.firstLine = firstLine;
+        chunks.push_back(chunk);
+    }
+    return chunks;
+}
+
+// Method to parse a chunk into its buffers, recording a malformed row in the chunk
+void RatingFileReader::parseChunk(RatingChunk& chunk) const{
+    chunk.failed = !scan(chunk.first, chunk.last, chunk.firstLine, chunk.stats, chunk.error,
+        [&](const char* name, int length){
+            chunk.names.push_back(name);
+            chunk.nameLengths.push_back(length);
+            chunk.rowStart.push_back(chunk.bookIds.size());
+        },
+        [&](int, int book, int rating){
+            chunk.bookIds.push_back(book);
+            chunk.values.push_back((int8_t)rating);
+        });
+    chunk.rowStart.push_back(chunk.bookIds.size());
+}
@@ -0,0 +1,259 @@
+//
+// Created by Shikha Pallavi on 10/16/26.
+//
+
+#ifndef P1_RATINGFILEREADER_H
+#define P1_RATINGFILEREADER_H
+
+// AUTHOR: Shikha Pallavi
+// PROGRAM: RatingFileReader.h
+// DATE: 10/16/2026
+// PURPOSE: Header file for a fast reader of ratings files (a member name line, then a line of ratings).
+// INPUT: None directly from the user. The program passes the path of the ratings file.
+// PROCESS: The file is memory mapped and scanned in place. Lines are split with memchr, which the C
+// library vectorises, and each ratings line is parsed by a hand-written scanner: optional sign, digits,
+// spaces. Runs of "0 0 0 0 " are recognised eight bytes at a time (twelve for the right-aligned cells of
+// a fixed-width file), since most cells of a ratings file are zero. Zero cells are skipped (the rating map starts out zero) and member names are handed over as a
+// pointer into the mapping, so nothing is allocated per cell. A malformed row stops the read with an
+// error naming the line and column.
+// Large files are cut into chunks at record boundaries (a chunk always starts on a name line), and the
+// chunks are parsed on the caller's thread pool into per-chunk buffers: the names, and the ratings as
+// compressed rows. The buffers are handed over whole, chunk by chunk in file order, so the caller can add a
+// chunk's members and ratings in one bulk step and ids match a serial read. Chunks are parsed a batch
+// of one per thread at a time, so only that many buffers are held at once.
+// OUTPUT: None directly. The reader hands over every parsed chunk and records LoadStats (bytes, lines,
+// members, ratings, chunks, seconds) for the throughput report.
+
+#include<iostream>
+#include<string>
+#include<vector>
+#include<cstring>
+#include<cstdint>
+#include<chrono>
+#include<algorithm>
+#include "MappedFile.h"
+#include "RatingList.h"
+#include "ThreadPool.h"
+
+// Smallest ratings file worth splitting across threads, and the target size of one chunk
+#define PARALLEL_READ_MIN_BYTES (4LL * 1024 * 1024)
+#define READ_CHUNK_BYTES (2LL * 1024 * 1024)
+
+
+using namespace std;
+
+// Struct for the statistics of one read of a ratings file
+struct LoadStats{
+
+    long long bytes = 0;     // Size of the file
+    int lines = 0;           // Lines read
+    int members = 0;         // Member name lines read
+    long long ratings = 0;   // Non-zero ratings read
+    int chunks = 0;          // Number of chunks the file was parsed in
+    double seconds = 0;      // Time taken to read the file
+
+    // Method to get the read speed in megabytes (10^6 bytes) per second
+    double megabytesPerSecond() const{
+        return seconds > 0 ? bytes / 1e6 / seconds : 0;
+    }
+
+};
+
+// Struct for the parsed contents of one chunk of a ratings file
+struct RatingChunk{
+
+    const char* first;          // First byte of the chunk (always the start of a name line)
+    const char* last;           // One past the last byte of the chunk
+    int firstLine;              // Line number of the chunk's first line
+    vector<const char*> names;  // Member names, pointing into the mapped file
+    vector<int> nameLengths;    // Length of every member name
+    vector<uint64_t> rowStart;  // Start of every member's ratings, plus the end of the last row
+    vector<int32_t> bookIds;    // Rating column of every non-zero rating, row by row in file order
+    vector<int8_t> values;      // Value of every non-zero rating
+    LoadStats stats;            // Lines, members and ratings of the chunk
+    bool failed = false;        // Set when the chunk holds a malformed row
+    string error;               // Where and why the chunk failed
+
+};
+
+// Class for reading a ratings file through a memory mapping
+class RatingFileReader{
+private:
+
+    MappedFile file;    // Mapping of the ratings file
+    int bookLimit;      // Number of books a ratings line may cover
+    string error;       // Reason the last open or read failed
+    LoadStats stats;    // Statistics of the last read
+
+    // Method to describe a problem at a line and column of the file
+    static string where(int line, long long column, string message);
+
+    // Method to cut the file into chunks that each start on a name line
+    vector<RatingChunk> splitChunks(ThreadPool& pool);
+
+    // Method to parse a chunk into its buffers, recording a malformed row in the chunk
+    void parseChunk(RatingChunk& chunk) const;
+
+    // Method to parse the lines [p, end), the first one being line firstLine and a name line, calling
+    // addMember(name, length) and addRating(member, book, rating) with members numbered from 0; on a
+    // malformed row it stops, sets problem and returns false
+    template<typename AddMember, typename AddRating>
+    bool scan(const char* p, const char* end, int firstLine, LoadStats& counts, string& problem,
+              AddMember addMember, AddRating addRating) const{
+        bool nameLine = true;
+        int line = firstLine - 1;
+        while(p < end){
+            const char* eol = (const char*)memchr(p, '\n', end - p);
+            if(eol == nullptr){
+                eol = end;
+            }
+            const char* stop = (eol > p && eol[-1] == '\r') ? eol - 1 : eol;
+            line++;
+            counts.lines++;
+
+            if(nameLine){
+                addMember(p, (int)(stop - p));
+                counts.members++;
+            }
+            else{
+                const char* lineStart = p;
+                int book = 0;
+                while(true){
+                    while(p < stop && (*p == ' ' || *p == '\t')) p++;
+
+                    // Four zero cells at once, plain or right-aligned in two characters
+                    while(stop - p >= 8 && book + 4 <= bookLimit && memcmp(p, "0 0 0 0 ", 8) == 0){
+                        p += 8;
+                        book += 4;
+                    }
+                    while(stop - p >= 12 && book + 4 <= bookLimit && memcmp(p, "0  0  0  0  ", 12) == 0){
+                        p += 12;
+                        book += 4;
+                    }
+                    if(p == stop) break;
+
+                    bool negative = (*p == '-');
+                    const char* cell = p;
+                    if(*p == '-' || *p == '+') p++;
+                    if(p == stop || *p < '0' || *p > '9'){
+                        problem = where(line, cell - lineStart + 1, "expected a rating");
+                        return false;
+                    }
+                    int value = 0;
+                    while(p < stop && *p >= '0' && *p <= '9'){
+                        value = value*10 + (*p - '0');
+                        if(value > RATING_LIMIT){
+                            problem = where(line, cell - lineStart + 1, "rating out of range");
+                            return false;
+                        }
+                        p++;
+                    }
+                    if(p < stop && *p != ' ' && *p != '\t'){
+                        problem = where(line, p - lineStart + 1, string("unexpected character '") + *p + "'");
+                        return false;
+                    }
+                    if(book >= bookLimit){
+                        problem = where(line, cell - lineStart + 1,
+                                        "more ratings than the " + to_string(bookLimit) + " books");
+                        return false;
+                    }
+                    if(value != 0){
+                        addRating(counts.members - 1, book, negative ? -value : value);
+                        counts.ratings++;
+                    }
+                    book++;
+                }
+            }
+            nameLine = !nameLine;
+            p = eol + 1;
+        }
+        return true;
+    }
+
+public:
+
+    // Constructor to create a reader accepting at most books ratings per line
+    RatingFileReader(int books){
+        bookLimit = books;
+    }
+
+    // Method to map the ratings file, returning false if it cannot be opened
+    bool open(string filePath){
+        return file.open(filePath, error);
+    }
+
+    // Method to get the reason the last open or read failed
+    const string& getError() const{
+        return error;
+    }
+
+    // Method to check whether the file is large enough to be parsed in chunks on a thread pool
+    bool worthSplitting() const{
+        return (long long)file.size() >= PARALLEL_READ_MIN_BYTES;
+    }
+
+    // Method to get the statistics of the last read
+    const LoadStats& getStats() const{
+        return stats;
+    }
+
+    // Method to read the whole file, calling addChunk(chunk) for every parsed chunk in file order (members
+    // of a chunk are numbered from 0 within it); returns false at the first malformed row, after handing
+    // over the chunk that holds it with everything before the row. Files of PARALLEL_READ_MIN_BYTES or
+    // more are parsed on the caller's pool, so the read starts no threads of its own; with no pool, or a
+    // smaller file, the file is parsed as one chunk on the calling thread.
+    template<typename AddChunk>
+    bool read(AddChunk addChunk, ThreadPool* pool = nullptr){
+        auto started = chrono::steady_clock::now();
+        stats = LoadStats();
+        stats.bytes = file.size();
+
+        vector<RatingChunk> chunks;
+        if(!worthSplitting() || pool == nullptr){
+            RatingChunk whole;
+            whole.first = file.data();
+            whole.last = file.data() + file.size();
+            whole.firstLine = 1;
+            chunks.push_back(whole);
+            pool = nullptr;
+        }
+        else{
+            chunks = splitChunks(*pool);
+        }
+        stats.chunks = (int)chunks.size();
+
+        // Parse a batch of chunks side by side, then hand them over in file order and free their buffers,
+        // stopping after the first chunk with a malformed row
+        bool ok = true;
+        int threads = pool ? pool->size() : 1;
+        for(int batch = 0 ; batch<(int)chunks.size() && ok ; batch += threads){
+            int count = min(threads, (int)chunks.size() - batch);
+            if(pool){
+                pool->run(count, [&](int c){
+                    parseChunk(chunks[batch + c]);
+                });
+            }
+            else{
+                parseChunk(chunks[batch]);
+            }
+            for(int c = batch ; c<batch + count && ok ; c++){
+                RatingChunk& chunk = chunks[c];
+                addChunk(chunk);
+                stats.lines += chunk.stats.lines;
+                stats.members += chunk.stats.members;
+                stats.ratings += chunk.stats.ratings;
+                if(chunk.failed){
+                    error = chunk.error;
+                    ok = false;
+                }
+                chunk = RatingChunk();
+            }
+        }
+
+        stats.seconds = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+        return ok;
+    }
+
+};
+
+#endif //P1_RATINGFILEREADER_H
@@ -0,0 +1,82 @@
+//
+// Created by Shikha Pallavi on 10/16/26.
+//
+
+#ifndef P1_SCRATCHARENA_H
+#define P1_SCRATCHARENA_H
+
+// AUTHOR: Shikha Pallavi
+// PROGRAM: ScratchArena.h
+// DATE: 10/16/2026
+// PURPOSE: Header file for a scratch arena that hands out the short-lived arrays of one request and is
+// reset before the next, so requests after the first do not touch the heap.
+// INPUT: None directly from the user. A request asks the arena for arrays of plain values.
+// PROCESS: The arena hands out memory by moving a pointer forward through a block. When a block is used
+// up another one, at least twice as large, is taken from the heap. reset takes back everything handed out;
+// if the last request needed more than one block, they are replaced by one block holding their total, so
+// from then on a request of the same size fits in the one block and allocates nothing. Every block taken
+// from the heap is counted, which shows whether a run of requests allocated.
+// OUTPUT: None directly. The arena hands out arrays that stay valid until the next reset.
+
+#include<iostream>
+#include<string>
+#include<vector>
+#include<cstddef>
+
+// Bytes of the first block, and the alignment of every array handed out
+#define ARENA_FIRST_BLOCK 4096
+#define ARENA_ALIGN 16
+
+
+using namespace std;
+
+// Class for handing out the arrays of one request
+class ScratchArena{
+private:
+
+    vector<char*> blocks;       // Blocks taken from the heap, the one in use last
+    vector<size_t> blockBytes;  // Size of every block
+    size_t used;                // Bytes handed out from the last block
+    long long heapBlocks;       // Number of blocks ever taken from the heap
+
+    // Method to start a block with room for at least n bytes
+    void grow(size_t n);
+
+public:
+
+    // Constructor to create an arena with one block of the given size
+    ScratchArena(size_t initialBytes = ARENA_FIRST_BLOCK);
+
+    // Destructor to free every block
+    ~ScratchArena();
+
+    // The arena owns its blocks, so it is not copied
+    ScratchArena(const ScratchArena&) = delete;
+    ScratchArena& operator=(const ScratchArena&) = delete;
+
+    // Method to get an uninitialised array of n plain values, valid until the next reset
+    template<typename T>
+    T* allocate(int n){
+        size_t bytes = ((size_t)(n > 0 ? n : 1) * sizeof(T) + ARENA_ALIGN - 1) / ARENA_ALIGN * ARENA_ALIGN;
+        if(used + bytes > blockBytes.back()){
+            grow(bytes);
+        }
+        T* at = reinterpret_cast<T*>(blocks.back() + used);
+        used += bytes;
+        return at;
+    }
+
+    // Method to take back every array handed out since the last reset
+    void reset();
+
+    // Method to get the number of blocks ever taken from the heap
+    long long getHeapBlocks() const{
+        return heapBlocks;
+    }
+
+    // Method to get the bytes the arena holds
+    size_t capacityBytes() const;
+
+};
+
+#endif //P1_SCRATCHARENA_H
@@ -0,0 +1,118 @@
+
+// AUTHOR: Shikha Pallavi
+// PROGRAM: SimHashIndex.cpp
+// DATE: 10/16/2026
+
+// PURPOSE: This file contains the implementation of the locality-sensitive hash index over members.
+
+// INPUT: update takes a member, a book and the member's old and new rating; candidates takes a member id.
+
+// PROCESS: The hyperplanes are never stored: the side of a book on a hyperplane is a bit of a hash of
+// (table, bit, book), so any number of books can be added later. A member's projection on a hyperplane
+// is the sum of its ratings times those signs; a rating change adds delta times the sign to each of the
+// tables x bits projections, and the member moves bucket only in the tables whose signature changed.
+// Members enter the buckets with their first rating and leave them when their last rating is removed.
+
+// OUTPUT: None directly. The methods keep the buckets up to date and return candidate neighbours.
+
+#include<iostream>
+#include<string>
+#include<algorithm>
+#include "SimHashIndex.h"
+
+
+using namespace std;
+
+// Constructor to create an index of t tables of b bits for m members with no ratings
+SimHashIndex::SimHashIndex(int m, int t, int b){
+    tables = t;
+    bits = min(max(b, 1), 32);
+    members = 0;
+    buckets.resize(tables);
+    growMembers(m);
+}
+
+// Method to get the side (+1 or -1) of a book on one hyperplane
+int SimHashIndex::weight(int table, int bit, int book) const{
+
+    // Mix the hyperplane and the book into one 64-bit value (splitmix64 finaliser)
+    uint64_t x = ((uint64_t)(table * bits + bit) << 32) | (uint32_t)book;
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return (x & 1) ? 1 : -1;
+}
+
+// Method to remove a member from a bucket of a table
+void SimHashIndex::removeMember(int table, int member, uint32_t signature){
+    vector<int>& bucket = buckets[table][signature];
+    bucket.erase(find(bucket.begin(), bucket.end(), member));
+    if(bucket.empty()){
+        buckets[table].erase(signature);
+    }
+}
+
+// Method to cover m members; new members start with no ratings
+void SimHashIndex::growMembers(int m){
+    if(m <= members){
+        return;
+    }
+    projections.resize((size_t)m * tables * bits, 0);
+    signatures.resize((size_t)m * tables, 0);
+    ratedCount.resize(m, 0);
+    seen.resize(m, 0);
+    members = m;
+}
+
+// Method to change a member's rating of a book from oldRating to newRating
+void SimHashIndex::update(int member, int book, int oldRating, int newRating){
+    int delta = newRating - oldRating;
+    if(delta == 0){
+        return;
+    }
+    bool wasHashed = ratedCount[member] > 0;
+    ratedCount[member] += (newRating != 0) - (oldRating != 0);
+    bool isHashed = ratedCount[member] > 0;
+
+    for(int t = 0 ; t<tables ; t++){
+        int* projection = &projections[((size_t)member * tables + t) * bits];
+        uint32_t signature = 0;
+        for(int b = 0 ; b<bits ; b++){
+            projection[b] += delta * weight(t, b, book);
+            if(projection[b] > 0){
+                signature |= 1u << b;
+            }
+        }
+        uint32_t& current = signatures[(size_t)member * tables + t];
+        if(wasHashed && (!isHashed || signature != current)){
+            removeMember(t, member, current);
+        }
+        if(isHashed && (!wasHashed || signature != current)){
+            buckets[t][signature].push_back(member);
+        }
+        current = signature;
+    }
+}
+
+// Method to collect, once each, the other members that share a bucket with the user in any table
+void SimHashIndex::candidates(int user, vector<int>& found){
+    found.clear();
+    if(ratedCount[user] == 0){
+        return;
+    }
+    for(int t = 0 ; t<tables ; t++){
+        auto bucket = buckets[t].find(signatures[(size_t)user * tables + t]);
+        for(int m : bucket->second){
+            if(m != user && !seen[m]){
+                seen[m] = 1;
+                found.push_back(m);
+            }
+        }
+    }
+
+    // Leave the scratch flags cleared for the next request
+    for(int m : found){
+        seen[m] = 0;
+    }
+}
@@ -0,0 +1,69 @@
+//
+// Created by Shikha Pallavi on 10/16/26.
+//
+
+#ifndef P1_SIMHASHINDEX_H
+#define P1_SIMHASHINDEX_H
+
+// AUTHOR: Shikha Pallavi
+// PROGRAM: SimHashIndex.h
+// DATE: 10/16/2026
+// PURPOSE: Header file for a locality-sensitive hash index that finds candidate similar members quickly.
+// INPUT: None directly from the user. RatingList reports every change to a member's ratings.
+// PROCESS: Each of the index's tables hashes a member's rating vector to a signature of a few bits, one
+// bit per random hyperplane (the sign of the vector's projection on it). Members whose rating vectors
+// point the same way tend to share a signature, so the members in the user's buckets are likely
+// neighbours. Members who rated nothing are left out of the buckets. The projections are kept per
+// member and a rating change only adds its difference, so the index never has to be rebuilt. More
+// tables raise recall, more bits make buckets smaller and faster.
+// OUTPUT: None directly. The index returns the candidate neighbours of a member.
+
+#include<iostream>
+#include<string>
+#include<vector>
+#include<cstdint>
+#include<unordered_map>
+
+// Default number of hash tables and of signature bits per table (at most 32)
+#define LSH_DEFAULT_TABLES 8
+#define LSH_DEFAULT_BITS 12
+
+
+using namespace std;
+
+// Class for hashing members into buckets of likely similar members
+class SimHashIndex{
+private:
+
+    int tables;                      // Number of hash tables
+    int bits;                        // Number of signature bits per table
+    int members;                     // Number of members covered
+    vector<int> projections;         // Projection of each member on each hyperplane [member][table][bit]
+    vector<uint32_t> signatures;     // Signature of each member in each table [member][table]
+    vector<int> ratedCount;          // Number of books each member rated; members with none are not hashed
+    vector<unordered_map<uint32_t, vector<int>>> buckets;  // Members per signature, one map per table
+    vector<char> seen;               // Scratch flag per member while collecting candidates
+
+    // Method to get the side (+1 or -1) of a book on one hyperplane
+    int weight(int table, int bit, int book) const;
+
+    // Method to remove a member from a bucket of a table
+    void removeMember(int table, int member, uint32_t signature);
+
+public:
+
+    // Constructor to create an index of t tables of b bits for m members with no ratings
+    SimHashIndex(int m, int t, int b);
+
+    // Method to cover m members; new members start with no ratings
+    void growMembers(int m);
+
+    // Method to change a member's rating of a book from oldRating to newRating
+    void update(int member, int book, int oldRating, int newRating);
+
+    // Method to collect, once each, the other members that share a bucket with the user in any table
+    void candidates(int user, vector<int>& found);
+
+};
+
+#endif //P1_SIMHASHINDEX_H
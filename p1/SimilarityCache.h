@@ -0,0 +1,101 @@
+//
+// Created by Shikha Pallavi on 10/16/26.
+//
+
+#ifndef P1_SIMILARITYCACHE_H
+#define P1_SIMILARITYCACHE_H
+
+// AUTHOR: Shikha Pallavi
+// PROGRAM: SimilarityCache.h
+// DATE: 10/16/2026
+// PURPOSE: Header file for a cache of member similarities that answers the best neighbour of a member.
+// INPUT: None directly from the user. RatingList reports how much each pair's similarity changes.
+// PROCESS: Up to SIM_TABLE_MAX_MEMBERS members the cache is a dense triangular table with one entry
+// per pair, plus the best neighbour of every member, kept while it only gains and looked up again in
+// the member's row once it loses. Past that it keeps, per member, a list of at most SIM_TOP_K positive
+// neighbours with their exact similarity, and a ceiling no member left off the list can be above. A
+// change to a pair on someone's list is applied exactly; a change to a pair on no list can only raise
+// the ceilings of both members. Once a member's ceiling reaches its best listed neighbour the list cannot
+// answer and RatingList refreshes it from an exact search, so memory stays at SIM_TOP_K pairs a member.
+// A rating change only touches the pairs formed with the other raters of that book, so RatingList can
+// keep the cache exact by adding (new - old) * their rating to each of those pairs.
+// OUTPUT: None directly. The cache answers the best neighbour of a member.
+
+#include<iostream>
+#include<string>
+#include<vector>
+
+
+// Largest number of members kept in the dense triangular table (about 8 MB of pairs)
+#define SIM_TABLE_MAX_MEMBERS 2048
+
+// Neighbours kept per member once the table is dropped
+#define SIM_TOP_K 16
+
+
+using namespace std;
+
+// Struct for a neighbour on a member's list
+struct CachedNeighbour{
+
+    int member;      // Member ID
+    int similarity;  // Exact similarity with the list's owner (always positive)
+
+};
+
+// Class for caching member similarities
+class SimilarityCache{
+private:
+
+    int members;                      // Number of members covered
+    bool useTable;                    // True while the dense triangular table is used
+    vector<int> table;                // Pair (a < b) stored at b*(b-1)/2 + a
+    vector<int> bestOf;               // Best neighbour of every member in table mode (-1 until looked up)
+    vector<CachedNeighbour> lists;    // SIM_TOP_K neighbours per member, member m's from m * SIM_TOP_K
+    vector<int> listSizes;            // Number of neighbours on every member's list
+    vector<int> ceilings;             // Highest similarity a member left off the list can have
+
+    // Method to get the table slot of a pair of different members
+    static long long slot(int a, int b){
+        if(a > b){
+            int t = a;
+            a = b;
+            b = t;
+        }
+        return (long long)b * (b - 1) / 2 + a;
+    }
+
+    // Method to find b on a's list, or get null
+    CachedNeighbour* find(int a, int b);
+
+    // Method to set the exact similarity of b on a's list, taking b off it or putting b on it as needed
+    void place(int a, int b, int similarity, CachedNeighbour* entry);
+
+    // Method to keep the best neighbour of a in table mode after the pair with b changed by delta
+    void updateBest(int a, int b, int delta);
+
+    // Method to move the table into per-member lists
+    void convertToLists();
+
+public:
+
+    // Constructor to create a cache of zero similarities for m members
+    SimilarityCache(int m);
+
+    // Method to cover m members; new members start with zero similarity to everyone
+    void growMembers(int m);
+
+    // Method to add delta to the similarity of two different members
+    void add(int a, int b, int delta);
+
+    // Method to replace what is kept for a member (its row of the table, or its list) with the exact
+    // similarities given for the members in reached (members not in reached have similarity 0)
+    void refresh(int user, const vector<int>& reached, const vector<int>& similarity);
+
+    // Method to get the member most similar to the user, lowest id first on ties, or -1 when the cache
+    // cannot tell (the user's list needs a refresh, or the user has no positive neighbour)
+    int bestNeighbour(int user);
+
+};
+
+#endif //P1_SIMILARITYCACHE_H
@@ -0,0 +1,137 @@
+
+// AUTHOR: Shikha Pallavi
+// PROGRAM: SimilarityKernel.cpp
+// DATE: 10/16/2026
+
+// PURPOSE: This file contains the scalar and SIMD dot-product kernels and the runtime kernel selection.
+
+// INPUT: Each kernel takes two pointers to int8 ratings and the number of ratings to multiply.
+
+// PROCESS: The SIMD kernels sign-extend the ratings to 16 bits, multiply and add neighbouring pairs
+// into 32-bit lanes (madd), and finish the tail that does not fill a vector with the scalar loop.
+// supportedKernels asks the CPU (cpuid through __builtin_cpu_supports) which instruction sets it has;
+// dotKernel calls it the first time it is needed and keeps the widest kernel.
+
+// OUTPUT: None directly. The kernels return the sum of the products of the two runs.
+
+#include<iostream>
+#include<string>
+#include "SimilarityKernel.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SIMILARITY_X86_KERNELS 1
+#include<immintrin.h>
+#endif
+
+
+using namespace std;
+
+// Scalar reference kernel
+int dotScalar(const int8_t* a, const int8_t* b, int n){
+    int sum = 0;
+    for(int j = 0 ; j<n ; j++){
+        sum += a[j] * b[j];
+    }
+    return sum;
+}
+
+#ifdef SIMILARITY_X86_KERNELS
+
+// Method to add the four 32-bit lanes of an SSE register
+__attribute__((target("sse2")))
+static int horizontalSum(__m128i v){
+    v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+    v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(v);
+}
+
+// SSE2 kernel, 16 ratings per step
+__attribute__((target("sse2")))
+static int dotSSE2(const int8_t* a, const int8_t* b, int n){
+    __m128i zero = _mm_setzero_si128();
+    __m128i acc = _mm_setzero_si128();
+    int j = 0;
+    for( ; j + 16 <= n ; j += 16){
+        __m128i va = _mm_loadu_si128((const __m128i*)(a + j));
+        __m128i vb = _mm_loadu_si128((const __m128i*)(b + j));
+
+        // SSE2 has no sign-extending load, so interleave each byte with its sign mask
+        __m128i signA = _mm_cmpgt_epi8(zero, va);
+        __m128i signB = _mm_cmpgt_epi8(zero, vb);
+        acc = _mm_add_epi32(acc, _mm_madd_epi16(_mm_unpacklo_epi8(va, signA), _mm_unpacklo_epi8(vb, signB)));
+        acc = _mm_add_epi32(acc, _mm_madd_epi16(_mm_unpackhi_epi8(va, signA), _mm_unpackhi_epi8(vb, signB)));
+    }
+    return horizontalSum(acc) + dotScalar(a + j, b + j, n - j);
+}
+
+// AVX2 kernel, 32 ratings per step
+__attribute__((target("avx2")))
+static int dotAVX2(const int8_t* a, const int8_t* b, int n){
+    __m256i acc = _mm256_setzero_si256();
+    int j = 0;
+    for( ; j + 32 <= n ; j += 32){
+        __m256i a0 = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*)(a + j)));
+        __m256i b0 = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*)(b + j)));
+        __m256i a1 = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*)(a + j + 16)));
+        __m256i b1 = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*)(b + j + 16)));
+        acc = _mm256_add_epi32(acc, _mm256_madd_epi16(a0, b0));
+        acc = _mm256_add_epi32(acc, _mm256_madd_epi16(a1, b1));
+    }
+    __m128i half = _mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+    return horizontalSum(half) + dotScalar(a + j, b + j, n - j);
+}
+
+// AVX-512 kernel, 64 ratings per step
+__attribute__((target("avx512f,avx512bw")))
+static int dotAVX512(const int8_t* a, const int8_t* b, int n){
+    __m512i acc = _mm512_setzero_si512();
+    int j = 0;
+    for( ; j + 64 <= n ; j += 64){
+        __m512i a0 = _mm512_cvtepi8_epi16(_mm256_loadu_si256((const __m256i*)(a + j)));
+        __m512i b0 = _mm512_cvtepi8_epi16(_mm256_loadu_si256((const __m256i*)(b + j)));
+        __m512i a1 = _mm512_cvtepi8_epi16(_mm256_loadu_si256((const __m256i*)(a + j + 32)));
+        __m512i b1 = _mm512_cvtepi8_epi16(_mm256_loadu_si256((const __m256i*)(b + j + 32)));
+        acc = _mm512_add_epi32(acc, _mm512_madd_epi16(a0, b0));
+        acc = _mm512_add_epi32(acc, _mm512_madd_epi16(a1, b1));
+    }
+    __m256i quarter = _mm256_add_epi32(_mm512_maskz_extracti64x4_epi64(0xff, acc, 0),
+                                       _mm512_maskz_extracti64x4_epi64(0xff, acc, 1));
+    __m128i half = _mm_add_epi32(_mm256_castsi256_si128(quarter), _mm256_extracti128_si256(quarter, 1));
+    return horizontalSum(half) + dotScalar(a + j, b + j, n - j);
+}
+
+#endif
+
+// Method to get every kernel this CPU supports, scalar first and widest last
+vector<KernelChoice> supportedKernels(){
+    vector<KernelChoice> kernels = {{dotScalar, "scalar"}};
+#ifdef SIMILARITY_X86_KERNELS
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("sse2")){
+        kernels.push_back({dotSSE2, "sse2"});
+    }
+    if(__builtin_cpu_supports("avx2")){
+        kernels.push_back({dotAVX2, "avx2"});
+    }
+    if(__builtin_cpu_supports("avx512bw")){
+        kernels.push_back({dotAVX512, "avx512"});
+    }
+#endif
+    return kernels;
+}
+
+// Method to get the chosen kernel, detecting the CPU on the first call
+static const KernelChoice& kernelChoice(){
+    static const KernelChoice choice = supportedKernels().back();
+    return choice;
+}
+
+// Method to get the fastest kernel supported by this CPU (chosen once, then cached)
+DotKernel dotKernel(){
+    return kernelChoice().kernel;
+}
+
+// Method to get the name of the kernel returned by dotKernel()
+const char* dotKernelName(){
+    return kernelChoice().name;
+}
@@ -0,0 +1,50 @@
+//
+// Created by Shikha Pallavi on 10/16/26.
+//
+
+#ifndef P1_SIMILARITYKERNEL_H
+#define P1_SIMILARITYKERNEL_H
+
+// AUTHOR: Shikha Pallavi
+// PROGRAM: SimilarityKernel.h
+// DATE: 10/16/2026
+// PURPOSE: Header file for the dot-product kernels used to compare two members' rating rows.
+// INPUT: None directly from the user. The kernels take two runs of int8 ratings of the same length.
+// PROCESS: An unrated book has rating 0, so its product is 0 and no per-cell test is needed: the
+// similarity is the plain dot product. A scalar reference kernel is always available; on x86 the
+// SSE2, AVX2 and AVX-512 versions are compiled with per-function target attributes and the widest
+// one the CPU supports is picked once at startup. All kernels return exactly the same sums.
+// OUTPUT: None directly. The kernels return the dot product of the two runs.
+
+#include<iostream>
+#include<string>
+#include<cstdint>
+#include<vector>
+
+
+using namespace std;
+
+// Function type of a dot-product kernel over n int8 ratings
+typedef int (*DotKernel)(const int8_t* a, const int8_t* b, int n);
+
+// Struct for a kernel and the name of the instruction set it uses
+struct KernelChoice{
+
+    DotKernel kernel;   // Kernel to call
+    const char* name;   // Name of the instruction set it uses
+
+};
+
+// Scalar reference kernel
+int dotScalar(const int8_t* a, const int8_t* b, int n);
+
+// Method to get every kernel this CPU supports, scalar first and widest last
+vector<KernelChoice> supportedKernels();
+
+// Method to get the fastest kernel supported by this CPU (chosen once, then cached)
+DotKernel dotKernel();
+
+// Method to get the name of the kernel returned by dotKernel()
+const char* dotKernelName();
+
+#endif //P1_SIMILARITYKERNEL_H
@@ -0,0 +1,178 @@
+
+// AUTHOR: Shikha Pallavi
+// PROGRAM: SparseRatings.cpp
+// DATE: 10/16/2026
+
+// PURPOSE: This file contains the implementation of the sparse CSR rating store.
+
+// INPUT: The set method takes a member, a book and a rating. appendRows takes whole rows of ratings. The dot
+// method takes two member ids.
+
+// PROCESS: set records the rating in the delta buffer and merges once the buffer grows past a fraction
+// of the stored ratings. merge sorts the buffered cells and rebuilds the rows in one pass, dropping
+// zero ratings. dot walks two sorted rows side by side, so it costs the length of the two rows rather
+// than the size of the catalog. appendRows copies rows that are already in CSR form (sorted, in range)
+// to the end of the arrays and only sets the row offsets, so a bulk load never goes through the buffer.
+
+// OUTPUT: None directly. The methods keep the CSR rows up to date and return ratings and similarities.
+
+#include<iostream>
+#include<string>
+#include<algorithm>
+#include "SparseRatings.h"
+
+
+using namespace std;
+
+// Method to add empty rows until the store has m members
+void SparseRatings::growMembers(int m){
+    if(m <= members){
+        return;
+    }
+    rowStart.resize(m + 1, rowStart[members]);
+    members = m;
+}
+
+// Method to get the rating of a member for a book (0 if unrated)
+int SparseRatings::get(int member, int book) const{
+
+    // Ratings still in the delta buffer are the newest ones
+    if(!pending.empty()){
+        auto it = pending.find(cellKey(member, book));
+        if(it != pending.end()){
+            return it->second;
+        }
+    }
+
+    // Binary search the member's sorted row
+    const int* first = bookIds.data() + rowStart[member];
+    const int* last = bookIds.data() + rowStart[member + 1];
+    const int* pos = lower_bound(first, last, book);
+    if(pos != last && *pos == book){
+        return values[pos - bookIds.data()];
+    }
+    return 0;
+}
+
+// Method to set the rating of a member for a book, buffering it until the next merge
+void SparseRatings::set(int member, int book, int rating){
+    pending[cellKey(member, book)] = (int8_t)rating;
+
+    // Merge in batches so the cost of rebuilding the rows is spread over many ratings
+    size_t limit = max((size_t)SPARSE_MIN_MERGE, bookIds.size() / 4);
+    if(pending.size() >= limit){
+        merge();
+    }
+}
+
+// Method to merge the delta buffer into the CSR rows
+void SparseRatings::merge(){
+    if(pending.empty()){
+        return;
+    }
+
+    // Sort the buffered cells by member, then by book
+    vector<pair<long long, int8_t>> delta(pending.begin(), pending.end());
+    sort(delta.begin(), delta.end());
+    pending.clear();
+
+    vector<int> newStart(members + 1, 0);
+    vector<int> newBooks;
+    vector<int8_t> newValues;
+    newBooks.reserve(bookIds.size() + delta.size());
+    newValues.reserve(bookIds.size() + delta.size());
+
+    // Merge every row with its buffered cells; a buffered cell replaces the stored one
+    size_t d = 0;
+    for(int m = 0 ; m<members ; m++){
+        int k = rowStart[m];
+        int end = rowStart[m + 1];
+        while(k < end || (d < delta.size() && (int)(delta[d].first >> 32) == m)){
+            bool fromDelta = d < delta.size() && (int)(delta[d].first >> 32) == m;
+            int deltaBook = fromDelta ? (int)(delta[d].first & 0xffffffff) : 0;
+            if(fromDelta && (k >= end || deltaBook <= bookIds[k])){
+                if(k < end && deltaBook == bookIds[k]){
+                    k++;
+                }
+                if(delta[d].second != 0){
+                    newBooks.push_back(deltaBook);
+                    newValues.push_back(delta[d].second);
+                }
+                d++;
+            }
+            else{
+                newBooks.push_back(bookIds[k]);
+                newValues.push_back(values[k]);
+                k++;
+            }
+        }
+        newStart[m + 1] = (int)newBooks.size();
+    }
+
+    rowStart.swap(newStart);
+    bookIds.swap(newBooks);
+    values.swap(newValues);
+}
+
+// Method to add whole rows at once: member first + i rated bookIds[k] with values[k] for k in
+// [rowStart[i], rowStart[i + 1]). Works only if the members from first on have no merged ratings yet
+// (returning false, with nothing stored, otherwise); rows sorted by book, with every book below
+// bookLimit and every value non-zero, go straight to the end of the CSR arrays, and the cells of any
+// other row (those below bookLimit) go through the delta buffer.
+bool SparseRatings::appendRows(int first, int count, const uint64_t* rowStart, const int32_t* bookIds,
+                               const int8_t* values, int bookLimit){
+    if(first < 0 || count < 0 || first + count > members || this->rowStart[first] != (int)this->bookIds.size()){
+        return false;
+    }
+
+    // Rows that are not in CSR form are set once every offset is right, since a set may merge
+    vector<int> buffered;
+    for(int i = 0 ; i<count ; i++){
+        uint64_t begin = rowStart[i], end = rowStart[i + 1];
+        bool clean = true;
+        for(uint64_t k = begin ; k<end && clean ; k++){
+            clean = bookIds[k] >= 0 && bookIds[k] < bookLimit && values[k] != 0 &&
+                    (k == begin || bookIds[k] > bookIds[k - 1]);
+        }
+        if(clean){
+            this->bookIds.insert(this->bookIds.end(), bookIds + begin, bookIds + end);
+            this->values.insert(this->values.end(), values + begin, values + end);
+        }
+        else{
+            buffered.push_back(i);
+        }
+        this->rowStart[first + i + 1] = (int)this->bookIds.size();
+    }
+    for(int m = first + count + 1 ; m<=members ; m++){
+        this->rowStart[m] = (int)this->bookIds.size();
+    }
+    for(int i : buffered){
+        for(uint64_t k = rowStart[i] ; k<rowStart[i + 1] ; k++){
+            if(bookIds[k] >= 0 && bookIds[k] < bookLimit){
+                set(first + i, bookIds[k], values[k]);
+            }
+        }
+    }
+    return true;
+}
+
+// Method to compute the sum of rating products over the books both members rated (rows must be merged)
+int SparseRatings::dot(int a, int b) const{
+    int i = rowStart[a], iEnd = rowStart[a + 1];
+    int j = rowStart[b], jEnd = rowStart[b + 1];
+    int sum = 0;
+    while(i < iEnd && j < jEnd){
+        if(bookIds[i] < bookIds[j]){
+            i++;
+        }
+        else if(bookIds[i] > bookIds[j]){
+            j++;
+        }
+        else{
+            sum += values[i] * values[j];
+            i++;
+            j++;
+        }
+    }
+    return sum;
+}
@@ -0,0 +1,172 @@
+
+// AUTHOR: Shikha Pallavi
+// PROGRAM: StringPool.cpp
+// DATE: 10/16/2026
+
+// PURPOSE: This file contains the implementation of the interned string pool.
+
+// INPUT: intern takes the bytes of a string and their count. adopt takes the chunks of a snapshot.
+
+// PROCESS: intern hashes the string (64-bit FNV-1a) and probes the open-addressing table of handles,
+// comparing lengths and bytes, until it finds the string or a free slot. A new string is appended to the
+// last chunk; when it does not fit, a new chunk is started (a string longer than a chunk gets a chunk of
+// its own). The table is doubled when it is half full, so probes stay short. Adopted chunks replace the
+// pool's only chunk (which holds just the empty string, as does the start of the first adopted chunk), and
+// the next new string starts a chunk of the pool's own. The first intern after an adopt walks the records
+// of the adopted chunks (length, bytes, null) and puts every one in a table sized for them.
+
+// OUTPUT: intern returns the handle of the string.
+
+#include<iostream>
+#include<string>
+#include<cstring>
+#include<cstdlib>
+#include "StringPool.h"
+#include "Fnv.h"
+
+
+using namespace std;
+
+// Function to get the pool shared by every book and member
+StringPool& stringPool(){
+    static StringPool pool;
+    return pool;
+}
+
+// Constructor to create a pool holding only the empty string (handle 0)
+StringPool::StringPool(){
+    used = STRING_CHUNK_BYTES;
+    count = 0;
+    bytes = 0;
+    adopted = 0;
+    indexed = true;
+    slots.assign(1024, STRING_SLOT_EMPTY);
+    intern("", 0);
+}
+
+// Destructor to free every chunk
+StringPool::~StringPool(){
+    for(size_t c = adopted ; c<chunks.size() ; c++){
+        delete[] chunks[c];
+    }
+}
+
+// Method to copy a string into the pool and return its handle
+StringHandle StringPool::store(const char* s, size_t n){
+    size_t need = sizeof(uint32_t) + n + 1;
+    if(used + need > STRING_CHUNK_BYTES){
+        if(chunks.size() >= ((size_t)1 << (32 - STRING_CHUNK_BITS))){
+            cout<<"Error: the string pool is full.\n";
+            exit(1);
+        }
+
+        // A long string fills a chunk of its own; the next string starts a new one
+        size_t chunkBytes = need > STRING_CHUNK_BYTES ? need : STRING_CHUNK_BYTES;
+        chunks.push_back(new char[chunkBytes]);
+        filled.push_back(0);
+        bytes += chunkBytes;
+        used = 0;
+    }
+    StringHandle h = (StringHandle)((chunks.size() - 1) << STRING_CHUNK_BITS) + used;
+    char* at = chunks.back() + used;
+    uint32_t length = (uint32_t)n;
+    memcpy(at, &length, sizeof(length));
+    memcpy(at + sizeof(length), s, n);
+    at[sizeof(length) + n] = '\0';
+    filled.back() = used + need;
+    used = need > STRING_CHUNK_BYTES ? STRING_CHUNK_BYTES : used + need;
+    return h;
+}
+
+// Method to double the hash table
+void StringPool::growTable(){
+    vector<StringHandle> old;
+    old.swap(slots);
+    slots.assign(old.size() * 2, STRING_SLOT_EMPTY);
+    for(StringHandle h : old){
+        if(h != STRING_SLOT_EMPTY){
+            insertSlot(h);
+        }
+    }
+}
+
+// Method to put a handle in the hash table, which must have room for it
+void StringPool::insertSlot(StringHandle h){
+    size_t mask = slots.size() - 1;
+    size_t i = hashBytes(data(h), length(h)) & mask;
+    while(slots[i] != STRING_SLOT_EMPTY){
+        i = (i + 1) & mask;
+    }
+    slots[i] = h;
+}
+
+// Method to build the hash table from the adopted chunks
+void StringPool::indexAdopted(){
+    size_t size = 1024;
+    while(count * 2 > size){
+        size *= 2;
+    }
+    slots.assign(size, STRING_SLOT_EMPTY);
+    for(size_t c = 0 ; c<adopted ; c++){
+        uint32_t at = 0;
+        while(at < filled[c]){
+            StringHandle h = (StringHandle)(c << STRING_CHUNK_BITS) + at;
+            insertSlot(h);
+            at += sizeof(uint32_t) + length(h) + 1;
+        }
+    }
+    indexed = true;
+}
+
+// Method to use n chunks written by an earlier pool (starts[c] holding sizes[c] bytes, count strings in
+// all) in place of this pool's contents; the chunks must outlive the pool's use. Only a pool holding
+// nothing but the empty string can adopt chunks, so every handle of the chunks keeps its meaning.
+bool StringPool::adopt(const char* const* starts, const uint32_t* sizes, size_t n, size_t strings){
+    uint32_t emptyLength = 1;
+    if(count != 1 || chunks.size() != 1 || n == 0 || n > ((size_t)1 << (32 - STRING_CHUNK_BITS)) ||
+       sizes[0] < sizeof(uint32_t) + 1){
+        return false;
+    }
+    memcpy(&emptyLength, starts[0], sizeof(emptyLength));
+    if(emptyLength != 0){
+        return false;
+    }
+    delete[] chunks[0];
+    bytes = 0;
+    // Adopted chunks are only read, since new strings never go into them
+    chunks.resize(n);
+    for(size_t c = 0 ; c<n ; c++){
+        chunks[c] = const_cast<char*>(starts[c]);
+    }
+    filled.assign(sizes, sizes + n);
+    adopted = n;
+    count = strings;
+
+    // New strings go in a chunk of the pool's own, and the table is built on the first intern
+    used = STRING_CHUNK_BYTES;
+    indexed = false;
+    return true;
+}
+
+// Method to get the handle of a string, adding it to the pool if it is not there yet
+StringHandle StringPool::intern(const char* s, size_t n){
+    if(!indexed){
+        indexAdopted();
+    }
+    size_t mask = slots.size() - 1;
+    size_t i = hashBytes(s, n) & mask;
+    while(slots[i] != STRING_SLOT_EMPTY){
+        StringHandle h = slots[i];
+        if(length(h) == n && memcmp(data(h), s, n) == 0){
+            return h;
+        }
+        i = (i + 1) & mask;
+    }
+    StringHandle h = store(s, n);
+    slots[i] = h;
+    count++;
+    if(count * 2 > slots.size()){
+        growTable();
+    }
+    return h;
+}
@@ -0,0 +1,201 @@
+//
+// Created by Shikha Pallavi on 10/16/26.
+//
+
+#ifndef P1_STRINGPOOL_H
+#define P1_STRINGPOOL_H
+
+// AUTHOR: Shikha Pallavi
+// PROGRAM: StringPool.h
+// DATE: 10/16/2026
+// PURPOSE: Header file for a pool that keeps one copy of every author, title and member name and hands out
+// 32-bit handles to them, so books and members hold a handle instead of a string.
+// INPUT: None directly from the user. Strings are interned as books and members are added.
+// PROCESS: Strings are stored one after the other in 64 KB chunks as a length, the bytes and a closing
+// null. A handle is the chunk number followed by the offset inside the chunk, so it never changes once
+// handed out: chunks are never moved or freed. A hash table of handles finds a string that is already in
+// the pool, so interning the same author twice gives the same handle and equal strings have equal handles.
+// Handle 0 is the empty string. The pool is shared by the whole program and used from the main thread only.
+// A snapshot stores the pool's chunks as they are, and a fresh pool can adopt them straight from the
+// mapped file: the chunks are used in place, the handles kept in the snapshot stay valid, and the hash
+// table is only built from them the first time a string is interned.
+// PooledString wraps a handle so a Book or Member field still prints, compares and reports its size like a
+// string, while the record itself stays a few plain integers that are copied with memcpy.
+// OUTPUT: None directly. The pool hands out handles and reads strings back from them.
+
+#include<iostream>
+#include<string>
+#include<vector>
+#include<cstdint>
+#include<cstring>
+
+// Size of a chunk of the pool, and the handle bits that hold the offset inside a chunk
+#define STRING_CHUNK_BITS 16
+#define STRING_CHUNK_BYTES (1 << STRING_CHUNK_BITS)
+
+// Marks a free slot of the hash table (no string can start at the last byte of a chunk)
+#define STRING_SLOT_EMPTY 0xFFFFFFFFu
+
+
+using namespace std;
+
+typedef uint32_t StringHandle;
+
+// Class for storing every distinct string once
+class StringPool{
+private:
+
+    vector<char*> chunks;        // Chunks of the pool, in the order they were allocated
+    vector<uint32_t> filled;     // Bytes used in every chunk
+    uint32_t used;               // Bytes used in the last chunk
+    size_t adopted;              // Number of leading chunks adopted from a snapshot (not owned by the pool)
+    bool indexed;                // False until the adopted strings are in the hash table
+    vector<StringHandle> slots;  // Hash table of the interned strings, STRING_SLOT_EMPTY when free
+    size_t count;                // Number of strings interned
+    size_t bytes;                // Bytes of the chunks
+
+    // Method to copy a string into the pool and return its handle
+    StringHandle store(const char* s, size_t n);
+
+    // Method to double the hash table
+    void growTable();
+
+    // Method to put a handle in the hash table, which must have room for it
+    void insertSlot(StringHandle h);
+
+    // Method to build the hash table from the adopted chunks
+    void indexAdopted();
+
+    // Method to get the start of a string's record (its length, then its bytes)
+    const char* record(StringHandle h) const{
+        return chunks[h >> STRING_CHUNK_BITS] + (h & (STRING_CHUNK_BYTES - 1));
+    }
+
+public:
+
+    // Constructor to create a pool holding only the empty string (handle 0)
+    StringPool();
+
+    // Destructor to free every chunk
+    ~StringPool();
+
+    // Method to get the handle of a string, adding it to the pool if it is not there yet
+    StringHandle intern(const char* s, size_t n);
+
+    // Method to get the bytes of a string, followed by a null
+    const char* data(StringHandle h) const{
+        return record(h) + sizeof(uint32_t);
+    }
+
+    // Method to get the length of a string
+    size_t length(StringHandle h) const{
+        uint32_t n;
+        memcpy(&n, record(h), sizeof(n));
+        return n;
+    }
+
+    // Method to get the number of distinct strings in the pool
+    size_t size() const{
+        return count;
+    }
+
+    // Method to get the memory held by the pool's chunks in bytes
+    size_t memoryBytes() const{
+        return bytes;
+    }
+
+    // Method to get the number of chunks
+    size_t chunkCount() const{
+        return chunks.size();
+    }
+
+    // Method to get the start of a chunk
+    const char* chunkData(size_t c) const{
+        return chunks[c];
+    }
+
+    // Method to get the bytes used in a chunk
+    uint32_t chunkBytes(size_t c) const{
+        return filled[c];
+    }
+
+    // Method to use n chunks written by an earlier pool (starts[c] holding sizes[c] bytes, count strings in
+    // all) in place of this pool's contents; the chunks must outlive the pool's use. Only a pool holding
+    // nothing but the empty string can adopt chunks, so every handle of the chunks keeps its meaning.
+    bool adopt(const char* const* starts, const uint32_t* sizes, size_t n, size_t strings);
+
+};
+
+// Function to get the pool shared by every book and member
+StringPool& stringPool();
+
+// Struct for a string kept in the shared pool
+struct PooledString{
+
+    StringHandle handle;  // Handle of the string in the pool
+
+    // Default constructor for the empty string
+    PooledString(){
+        handle = 0;
+    }
+
+    // Method to wrap a handle the pool already handed out
+    static PooledString fromHandle(StringHandle h){
+        PooledString s;
+        s.handle = h;
+        return s;
+    }
+
+    // Constructor to intern a string
+    PooledString(const string& s){
+        handle = stringPool().intern(s.data(), s.size());
+    }
+
+    // Constructor to intern a null-terminated string
+    PooledString(const char* s){
+        handle = stringPool().intern(s, strlen(s));
+    }
+
+    // Constructor to intern n bytes
+    PooledString(const char* s, size_t n){
+        handle = stringPool().intern(s, n);
+    }
+
+    // Method to get the bytes of the string, followed by a null
+    const char* data() const{
+        return stringPool().data(handle);
+    }
+
+    // Method to get the length of the string
+    size_t size() const{
+        return stringPool().length(handle);
+    }
+
+    // Method to check whether the string is empty
+    bool empty() const{
+        return handle == 0;
+    }
+
+    // Method to copy the string out of the pool
+    string str() const{
+        return string(data(), size());
+    }
+
+    // Method to compare two pooled strings (interning makes equal strings share a handle)
+    bool operator==(const PooledString& other) const{
+        return handle == other.handle;
+    }
+
+    // Method to compare two pooled strings
+    bool operator!=(const PooledString& other) const{
+        return handle != other.handle;
+    }
+
+};
+
+// Function to print a pooled string
+inline ostream& operator<<(ostream& out, const PooledString& s){
+    return out.write(s.data(), s.size());
+}
+
+#endif //P1_STRINGPOOL_H
@@ -0,0 +1,105 @@
+
+// AUTHOR: Shikha Pallavi
+// PROGRAM: ThreadPool.cpp
+// DATE: 10/16/2026
+
+// PURPOSE: This file contains the implementation of the reusable thread pool.
+
+// INPUT: run takes the number of parts of a job and the function to call for each part.
+
+// PROCESS: run publishes the job under the lock and wakes the workers. Every thread, the caller
+// included, repeatedly claims the next part number and runs it with the lock released. run returns
+// once the count of finished parts reaches the number of parts, so the next job can reuse the pool.
+
+// OUTPUT: None directly. The parts report their results through the job function.
+
+#include<iostream>
+#include<string>
+#include "ThreadPool.h"
+
+
+using namespace std;
+
+// Constructor to start the pool; threads <= 0 uses every hardware thread
+ThreadPool::ThreadPool(int threads){
+    if(threads <= 0){
+        threads = (int)thread::hardware_concurrency();
+    }
+    if(threads <= 0){
+        threads = 1;
+    }
+    job = nullptr;
+    parts = 0;
+    nextPart = 0;
+    doneParts = 0;
+    stopping = false;
+    for(int i = 1 ; i<threads ; i++){
+        workers.push_back(thread(&ThreadPool::workerLoop, this));
+    }
+}
+
+// Destructor to stop and join the worker threads
+ThreadPool::~ThreadPool(){
+    {
+        lock_guard<mutex> held(lock);
+        stopping = true;
+    }
+    wake.notify_all();
+    for(size_t i = 0 ; i<workers.size() ; i++){
+        workers[i].join();
+    }
+}
+
+// Method to take parts of the current job until none are left
+void ThreadPool::work(unique_lock<mutex>& held){
+    while(job != nullptr && nextPart < parts){
+        int part = nextPart++;
+        const function<void(int)>* task = job;
+        held.unlock();
+        (*task)(part);
+        held.lock();
+        doneParts++;
+        if(doneParts == parts){
+            finished.notify_all();
+        }
+    }
+}
+
+// Method run by every worker thread
+void ThreadPool::workerLoop(){
+    unique_lock<mutex> held(lock);
+    while(true){
+        wake.wait(held, [this]{ return stopping || (job != nullptr && nextPart < parts); });
+        if(stopping){
+            return;
+        }
+        work(held);
+    }
+}
+
+// Method to run task(0) .. task(count-1) across the pool and wait for all of them
+void ThreadPool::run(int count, const function<void(int)>& task){
+    if(count <= 0){
+        return;
+    }
+
+    // Small jobs and single-thread pools run on the caller only
+    if(count == 1 || workers.empty()){
+        for(int i = 0 ; i<count ; i++){
+            task(i);
+        }
+        return;
+    }
+
+    unique_lock<mutex> held(lock);
+    job = &task;
+    parts = count;
+    nextPart = 0;
+    doneParts = 0;
+    wake.notify_all();
+
+    // The caller helps with the parts, then waits for the ones still running elsewhere
+    work(held);
+    finished.wait(held, [this]{ return doneParts == parts; });
+    job = nullptr;
+}
@@ -18,11 +18,14 @@
 #include "BookList.h"
 #include "MemberList.h"
 #include "RatingList.h"
+#include "RatingFileReader.h"
 #include<sstream>
 #include<fstream>
 
 #define INITIAL_MEM_CAP 100
 #define INITIAL_BOOK_CAP	100
+#define RECOMMEND_THREADS	0	// Threads shared by the similar-member search and the ratings load (0 = all hardware threads)
+#define SIMILARITY_CACHE	0	// Keep member similarities up to date on every rating (1 = on)
 
 
 using namespace std;
@@ -40,6 +43,7 @@ struct Session{
     int capacityMembers;  // Capacity of members array
     int capacityBooks;  // Capacity of books array
     int loggedInUser = -1;  // ID of the currently logged-in user
+    ScratchArena scratch;  // Arrays of the current recommendation, reused by the next one
 
 
     // Constructor to initialize session with default capacities
@@ -47,6 +51,8 @@ struct Session{
         memRecord = new MemberList(INITIAL_MEM_CAP);
         bookRecord = new BookList(INITIAL_BOOK_CAP);
         ratings = new RatingList(INITIAL_MEM_CAP,INITIAL_BOOK_CAP);
+        ratings->setThreadCount(RECOMMEND_THREADS);
+        ratings->setSimilarityCache(SIMILARITY_CACHE);
         capacityMembers = INITIAL_MEM_CAP;
         capacityBooks = INITIAL_BOOK_CAP;
 
@@ -54,17 +60,27 @@ struct Session{
 
     // Method to get the rating of a member for a book
     int getRating(int member, int isbn ){
-        return (ratings->getRatingMap())[member][isbn];
+        return ratings->getRating(member, isbn);
     }
 
     // Method to get the profile of the currently logged-in user
     Member myProfile(){
-        return (memRecord->getMemberArray())[loggedInUser];
+        return memRecord->getMember(loggedInUser);
     }
 
     // Method to get details of a book by its ISBN
     Book bookDetail(int isbn){
-        return (bookRecord->getBookArray())[isbn];
+        return bookRecord->getBook(isbn);
+    }
+
+    // Method to find a book with the same author, title and year, returning its index or -1
+    int findBook(PooledString Author, PooledString Title, int Year){
+        return bookRecord->findBook(Author, Title, Year);
+    }
+
+    // Method to get the IDs of every member with a name, in account order
+    void findMembers(string name, vector<int>& accounts){
+        memRecord->findMembers(name.data(), name.size(), accounts);
     }
 
     // Method to get the ID of the currently logged-in user
@@ -130,8 +146,19 @@ struct Session{
         }
     }
 
+    // Method to make room for numMembers members and numBooks books before a bulk load
+    void reserve(int numMembers, int numBooks){
+
+        // A list is grown once it is full, so keep one slot more than will be used
+        capacityMembers = max(capacityMembers, numMembers + 1);
+        capacityBooks = max(capacityBooks, numBooks + 1);
+        memRecord->reserve(capacityMembers);
+        bookRecord->reserve(capacityBooks);
+        ratings->reserve(capacityMembers, capacityBooks);
+    }
+
     // Method to add a new member
-    void addMember(string name){
+    void addMember(PooledString name){
 
         memRecord->addMember(name,loggedInUser);
         totalMembers++;
@@ -145,7 +172,7 @@ struct Session{
     }
 
     // Method to add a new book
-    void addBook(string Author, string Title, int Year){
+    void addBook(PooledString Author, PooledString Title, int Year){
 
         bookRecord->addBook(Author, Title, Year, loggedInUser);
         totalBooks++;
@@ -176,42 +203,65 @@ struct Session{
             cout<<"Book with ISBN no. ";
             cout<<book<<"does not exist in the database. \n";
         }
+        if(rating < -RATING_LIMIT || rating > RATING_LIMIT){
+            cout<<"Rating "<<rating<<" is out of range ("<<-RATING_LIMIT<<" to "<<RATING_LIMIT<<").\n";
+            return;
+        }
 
 
         // Add rating to the rating map
-        (ratings->getRatingMap())[member][book] = rating;
+        ratings->setRating(member, book, rating);
+    }
+
+    // Method to add the members of a parsed chunk of a ratings file with their ratings in one bulk step,
+    // rating column j going to book columns[j]
+    void addRatedMembers(RatingChunk& chunk, const vector<int>& columns){
+
+        int first = totalMembers;
+        int n = (int)chunk.names.size();
+        memRecord->addMembers(n, [&](int i){
+            return Member(PooledString(chunk.names[i], chunk.nameLengths[i]), first + i + 1, loggedInUser);
+        });
+        totalMembers += n;
+
+        // Resize members array until the new members fit
+        while(totalMembers >= capacityMembers){
+            ratings->resizeMembers();
+            capacityMembers = 2*capacityMembers;
+        }
+
+        // The rows are handed to the rating map whole once their columns are turned into books
+        for(int32_t& book : chunk.bookIds){
+            book = columns[book];
+        }
+        ratings->addRows(first, n, chunk.rowStart.data(), chunk.bookIds.data(), chunk.values.data());
     }
 
     // Method to get recommendations for the current user
     void getRecomendations(){
 
-        // Get recommendations based on similarity
-        int** similarity;
-        similarity = ratings->recomendBook(loggedInUser);
+        // Get recommendations based on similarity; the result lives in the scratch arena until the next request
+        scratch.reset();
+        Recommendation similarity = ratings->recomendBook(loggedInUser, scratch);
 
-        int* detail = 	similarity[0];
-        int* books = similarity[1];
-        int similarUser = detail[0];
-        int count = detail[1];
+        const int* books = similarity.books;
+        int similarUser = similarity.similarUser;
+        int count = similarity.count;
         int firstLimit = -1;
         int secondLimit = -1;
         cout<<"You have similar taste in books as ";
-        cout<< ((memRecord->getMemberArray())[similarUser]).Name;
+        cout<< memRecord->getName(similarUser);
         cout<<" !\n\n";
 
-        int* bestbooks = new int[count];
-        int* secondBestBooks =new  int[count];
-
         // Find Top rated books by similar user
         for(int i = 0 ; i<count ; i++){
-            int rating1 = (ratings->getRatingMap())[similarUser][books[i]];
-            int rating2 = (ratings->getRatingMap())[similarUser][books[i-1]];
+            int rating1 = ratings->getRating(similarUser, books[i]);
+            int rating2 = (i>0) ? ratings->getRating(similarUser, books[i-1]) : rating1;
             if(i>0 && rating1 != rating2){
 
                 break;
 
             }
-            bestbooks[i] = books[i];
             firstLimit = i;
 
         }
@@ -219,18 +269,17 @@ struct Session{
 
         // Find second Top rated books by similar user
         for(int i = firstLimit+1 ; i<count && firstLimit+1 > 0  ; i++){
-            int rating1 = (ratings->getRatingMap())[similarUser][books[i]];
-            int rating2 = (ratings->getRatingMap())[similarUser][books[i-1]];
+            int rating1 = ratings->getRating(similarUser, books[i]);
+            int rating2 = ratings->getRating(similarUser, books[i-1]);
             if(i>0 && (i != firstLimit+1) && rating1 != rating2){
                 break;
             }
-            secondBestBooks[i] = books[i];
             secondLimit = i;
         }
 
         cout<<"Here are the books they really liked: \n";
         for(int i = firstLimit ; i>=0 ; i--){
-            Book b = (bookRecord->getBookArray())[bestbooks[i]];
+            Book b = bookRecord->getBook(books[i]);
             cout<< b.ISBN <<", "<< b.Author << ", ";
             cout<< b.Title << ", " << b.Year <<"\n";
 
@@ -239,7 +288,7 @@ struct Session{
         cout<<"And here are the books they liked: \n";
 
         for(int i = secondLimit ; i>firstLimit ; i--){
-            Book b = (bookRecord->getBookArray())[secondBestBooks[i]];
+            Book b = bookRecord->getBook(books[i]);
             cout<< b.ISBN <<", "<< b.Author << ", " ;
             cout<< b.Title << ", " << b.Year <<"\n";
         }
@@ -288,17 +337,55 @@ void PromtaddMember(Session* s){
 
 }
 
-// Function to prompt user for login
+// Function to read a member account given as its number or as the member's name, returning the account
+// number (0 if no single member has the name)
+int readAccount(Session* s){
+
+    // Names may hold spaces, so the entry is the rest of the line, without the spaces around it
+    string entry;
+    cin>>ws;
+    getline(cin, entry);
+    entry.erase(entry.find_last_not_of(" \t\r") + 1);
+
+    // A number is an account if that account exists; anything else, and a number with no account
+    // behind it, is looked up as a name (so members whose names are digits can still log in by name)
+    bool digits = !entry.empty() && entry.find_first_not_of("0123456789") == string::npos;
+    if(digits && entry.size() <= 9 && stoi(entry) >= 1 && stoi(entry) <= s->getNumMembers()){
+        return stoi(entry);
+    }
+    vector<int> accounts;
+    s->findMembers(entry, accounts);
+    if(accounts.empty()){
+        if(digits){
+            cout<<"No member has account "<<entry<<" or is called "<<entry<<".\n";
+        }
+        else{
+            cout<<"No member is called "<<entry<<".\n";
+        }
+        return 0;
+    }
+    if(accounts.size() > 1){
+        cout<<"Several members are called "<<entry<<": accounts";
+        for(size_t i = 0 ; i<accounts.size() ; i++){
+            cout<<(i>0 ? ", " : " ")<<accounts[i]+1;
+        }
+        cout<<".\n";
+        return 0;
+    }
+    return accounts[0]+1;
+}
+
+// Function to prompt user for login, by account number or by name
 void PromtlogIN(Session* s){
     int mem;
-    cout<<"Enter member account: ";
-    cin>>mem;
+    cout<<"Enter member account or name: ";
+    mem = readAccount(s);
 
     while(mem <= 0){
         cout<<"\n";
-        cout<<"Please enter a valid account number (>0)\n";
-        cout<<"Enter member account: ";
-        cin>>mem;
+        cout<<"Please enter a valid account number (1 to "<<s->getNumMembers()<<") or member name\n";
+        cout<<"Enter member account or name: ";
+        mem = readAccount(s);
     }
 
     // cout<<"\n";
@@ -306,6 +393,19 @@ void PromtlogIN(Session* s){
     cout<<(s->myProfile()).Name<<", you are logged in!\n\n";
 }
 
+// Function to read a rating, asking again until it fits the rating map
+int readRating(){
+    int rating;
+    cout<<"Enter your rating: ";
+    cin>>rating;
+    while(rating < -RATING_LIMIT || rating > RATING_LIMIT){
+        cout<<"Please enter a rating between "<<-RATING_LIMIT<<" and "<<RATING_LIMIT<<"\n";
+        cout<<"Enter your rating: ";
+        cin>>rating;
+    }
+    return rating;
+}
+
 // Function to prompt user for rating a book
 void Promtrate(Session* s){
     int ISBN,rating;
@@ -323,8 +423,7 @@ void Promtrate(Session* s){
         cin>>verdict;
         //cout<<"\n";
         if(verdict[0]=='y'){
-            cout<<"Enter your rating: ";
-            cin>>rating;
+            rating = readRating();
             //cout<<"\n";
             s->addRating(s->currentUser(), ISBN-1, rating);
             cout<<"Your new rating for ";
@@ -335,8 +434,7 @@ void Promtrate(Session* s){
         }
     }
     else{
-        cout<<"Enter your rating: ";
-        cin>>rating;
+        rating = readRating();
         //cout<<"\n";
         s->addRating(s->currentUser(), ISBN-1, rating);
         cout<<"Your new rating for ";
@@ -391,8 +489,20 @@ int showLogInMenu(){
     return option;
 }
 
-// Function to read book data from a file
-int readBookFile(Session* s, string bookFile ){
+// Function to size a session for the books and members in the given files before reading them
+void presizeSession(Session* s, string bookFile, string ratingFile){
+    MappedFile books, ratings;
+    string error;
+
+    // One book per line; a member takes a name line and a ratings line
+    long long numBooks = books.open(bookFile, error) ? books.countLines() : 0;
+    long long numMembers = ratings.open(ratingFile, error) ? (ratings.countLines() + 1)/2 : 0;
+    s->reserve((int)numMembers, (int)numBooks);
+}
+
+// Function to read book data from a file, skipping books already in it;
+// columns receives the book every line of the file stands for
+int readBookFile(Session* s, string bookFile, vector<int>& columns){
 
     ifstream inputfile;
 
@@ -407,6 +517,7 @@ int readBookFile(Session* s, string bookFile ){
     string line;
     string author, title;
     int numBook = 0;
+    int duplicates = 0;
     int year = 1729;
 
 
@@ -419,7 +530,7 @@ int readBookFile(Session* s, string bookFile ){
 
 
             if(indicator == 0){
-                author = line;
+                author = word;
 
             }
             else if(indicator == 1){
@@ -429,8 +540,18 @@ int readBookFile(Session* s, string bookFile ){
             else if(indicator == 2){
                 // cout<<word<<endl;
                 year = stoi(word);
-                s->addBook(author, title, year);
-                numBook++;
+
+                // A book with the same author, title and year only keeps its first line
+                int book = s->findBook(author, title, year);
+                if(book < 0){
+                    s->addBook(author, title, year);
+                    book = s->getNumBooks() - 1;
+                    numBook++;
+                }
+                else{
+                    duplicates++;
+                }
+                columns.push_back(book);
 
             }
             indicator = (indicator+1)%3;
@@ -441,47 +562,34 @@ int readBookFile(Session* s, string bookFile ){
     }
 
     inputfile.close();
+    if(duplicates > 0){
+        cout<<"Skipped "<<duplicates<<" duplicate books in "<<bookFile<<"\n";
+    }
     return numBook;
 }
 
-// Function to read rating data from a file
-int readRatingFile(Session* s, string ratingFile){
-
-    ifstream inputfile;
-    inputfile.open(ratingFile);
+// Function to read rating data from a file, rating column j going to book columns[j]
+// (stats, if given, receives the read statistics)
+int readRatingFile(Session* s, string ratingFile, const vector<int>& columns, LoadStats* stats = nullptr){
 
-    if(!inputfile){
+    RatingFileReader reader((int)columns.size());
+    if(!reader.open(ratingFile)){
         cout<<"Error opening rating File.\n";
         return 0;
     }
 
-
-    string member;
-    string line;
-    int rating;
-    int indicator = 0;
-    int numMember = 0;
-    while(getline(inputfile, line)){
-        stringstream ss(line);
-        if(indicator == 0){
-            member = line;
-            s->addMember(member);
-            numMember++;
-        }
-        else{
-            int bookIndex = 0;
-
-            while(ss >> rating){
-                s->addRating(numMember-1, bookIndex, rating);
-                bookIndex++;
-            }
-
-        }
-        indicator = (indicator + 1) % 2;
-        // cin.ignore();
+    // Every parsed chunk goes in with one bulk step: names as pointers into the mapped file, and the
+    // non-zero ratings as rows
+    bool ok = reader.read([&](RatingChunk& chunk){
+        s->addRatedMembers(chunk, columns);
+    }, reader.worthSplitting() ? s->ratings->getPool() : nullptr);
+    if(!ok){
+        cout<<"Error in rating file "<<ratingFile<<", "<<reader.getError()<<"\n";
     }
-    inputfile.close();
-    return numMember;
+    if(stats){
+        *stats = reader.getStats();
+    }
+    return reader.getStats().members;
 }
 
 // Main function
@@ -508,8 +616,10 @@ int main(){
     cout<<"\n\n";
 
     currentSession->setAdminLogIn();
-    int numBook = readBookFile(currentSession, bookFile);
-    int numMember = readRatingFile(currentSession, ratingFile);
+    presizeSession(currentSession, bookFile, ratingFile);
+    vector<int> columns;
+    int numBook = readBookFile(currentSession, bookFile, columns);
+    int numMember = readRatingFile(currentSession, ratingFile, columns);
     currentSession->unsetAdminLogIn();
 
 
@@ -0,0 +1,399 @@
+
+// AUTHOR: Shikha Pallavi
+// PROGRAM: Benchmark.cpp
+// DATE: 10/17/2026
+
+// PURPOSE: This program times the hot paths of the recommendation engine on generated data, so the
+// speed-ups claimed for them can be measured again on any machine.
+
+// INPUT: The name of the benchmark to run as the first argument (or none to run them all):
+// kernels - the dot-product kernel of every instruction set this CPU supports
+// batch   - recommendations for every member, one member at a time and in one batch pass, dense and sparse
+// bits    - candidate ranking and co-rated counts with the rated-book bitsets and cell by cell
+// arena   - repeated recommendations from one scratch arena, checking it stops taking heap blocks
+// lsh     - recall@1 and time per query of the approximate neighbour search against the exact one
+
+// PROCESS: Every benchmark builds its data with a fixed seed, checks that the fast path returns the
+// same results as the reference it replaces, and then times both, repeating a run until it takes at
+// least BENCH_MIN_SECONDS so short runs are not lost in the clock's resolution.
+
+// OUTPUT: One line per timed variant (per hash setting for lsh), and "MISMATCH" (with exit status 1) if a fast path ever
+// disagrees with its reference or the arena takes a heap block once it is warm.
+
+#include<iostream>
+#include<string>
+#include<vector>
+#include<cstdint>
+#include<chrono>
+#include<random>
+#include<algorithm>
+#include "SimilarityKernel.h"
+#include "RatingList.h"
+#include "ScratchArena.h"
+
+// Shortest time a timed run is repeated for
+#define BENCH_MIN_SECONDS 0.2
+
+// Length of the rows the kernels are timed on (1 MB, larger than L2 so memory speed shows)
+#define BENCH_KERNEL_BYTES (1 << 20)
+
+// Catalog of the batch benchmark (a quarter of the cells rated) and the books recommended per member
+#define BENCH_BATCH_MEMBERS 4096
+#define BENCH_BATCH_BOOKS 2048
+#define BENCH_BATCH_LIMIT 10
+
+// Threads the batch pass is checked with, so parts really run side by side
+#define BENCH_CHECK_THREADS 4
+
+// Catalog of the bitset benchmark, the ratings of every member, and the members timed
+#define BENCH_BITS_MEMBERS 8192
+#define BENCH_BITS_BOOKS 4096
+#define BENCH_BITS_RATINGS 40
+#define BENCH_BITS_USERS 512
+
+// Members recommended to in every round of the arena check, and the rounds run after the first
+#define BENCH_ARENA_USERS 64
+#define BENCH_ARENA_ROUNDS 3
+
+// Catalog of the approximate search benchmark: members fall into taste groups that rate the books of
+// their group's shelf alike, plus a few books at random, and the members timed
+#define BENCH_LSH_MEMBERS 16384
+#define BENCH_LSH_BOOKS 8192
+#define BENCH_LSH_GROUPS 128
+#define BENCH_LSH_SHELF 256
+#define BENCH_LSH_RATINGS 40
+#define BENCH_LSH_RANDOM 8
+#define BENCH_LSH_USERS 512
+
+
+using namespace std;
+
+// Sum of the timed results, kept so the compiler cannot leave the timed work out
+volatile long long benchSink = 0;
+
+// Function to call run() until BENCH_MIN_SECONDS have passed and return the seconds one call takes
+template<typename Run>
+double timeRun(Run run){
+    auto started = chrono::steady_clock::now();
+    long long calls = 0;
+    double seconds = 0;
+    while(seconds < BENCH_MIN_SECONDS){
+        run();
+        calls++;
+        seconds = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+    }
+    return seconds / calls;
+}
+
+// Function to fill n ratings with values in -5..5, about one in four non-zero
+void fillRatings(int8_t* ratings, size_t n, mt19937& random){
+    uniform_int_distribution<int> cell(0, 3);
+    uniform_int_distribution<int> value(-5, 5);
+    for(size_t j = 0 ; j<n ; j++){
+        ratings[j] = cell(random) == 0 ? (int8_t)value(random) : 0;
+    }
+}
+
+// Function to time the dot-product kernel of every instruction set this CPU supports
+bool benchKernels(){
+    mt19937 random(5);
+    vector<int8_t> a(BENCH_KERNEL_BYTES), b(BENCH_KERNEL_BYTES);
+    fillRatings(a.data(), a.size(), random);
+    fillRatings(b.data(), b.size(), random);
+
+    bool ok = true;
+    int expected = dotScalar(a.data(), b.data(), BENCH_KERNEL_BYTES);
+    cout<<"kernels: dot product of two "<<BENCH_KERNEL_BYTES<<"-byte rows (picked: "<<dotKernelName()<<")\n";
+    for(const KernelChoice& k : supportedKernels()){
+        int sum = 0;
+        double seconds = timeRun([&](){
+            sum = k.kernel(a.data(), b.data(), BENCH_KERNEL_BYTES);
+        });
+        cout<<"  "<<k.name<<": "<<2.0 * BENCH_KERNEL_BYTES / seconds / 1e9<<" GB/s";
+        if(sum != expected){
+            cout<<"  MISMATCH ("<<sum<<" instead of "<<expected<<")";
+            ok = false;
+        }
+        cout<<"\n";
+    }
+    return ok;
+}
+
+// Function to give every member of a rating list perMember random non-zero ratings in -5..5
+void fillRatingList(RatingList& ratings, int members, int books, int perMember, mt19937& random){
+    uniform_int_distribution<int> book(0, books - 1);
+    uniform_int_distribution<int> value(1, 5);
+    uniform_int_distribution<int> sign(0, 1);
+    for(int m = 0 ; m<members ; m++){
+        for(int k = 0 ; k<perMember ; k++){
+            int v = value(random);
+            ratings.setRating(m, book(random), sign(random) ? v : -v);
+        }
+    }
+}
+
+// Function to check that a batch pass gives every member the same neighbour and books as recomendBook
+bool sameAsSingle(RatingList& ratings, const BatchRecommendations& batch, int members, int limit){
+    ScratchArena arena;
+    for(int m = 0 ; m<members ; m++){
+        arena.reset();
+        Recommendation one = ratings.recomendBook(m, limit, arena);
+        int found = batch.start[m + 1] - batch.start[m];
+        if(one.similarUser != batch.similarUser[m] || one.count != found ||
+           !equal(one.books, one.books + found, batch.bookIds.begin() + batch.start[m])){
+            return false;
+        }
+    }
+    return true;
+}
+
+// Function to time recommendations for every member, one at a time and in one batch pass, in the dense
+// map and in the sparse store
+bool benchBatch(){
+    bool ok = true;
+    for(bool useSparse : {false, true}){
+        mt19937 random(10);
+        RatingList ratings(BENCH_BATCH_MEMBERS, BENCH_BATCH_BOOKS, useSparse);
+        fillRatingList(ratings, BENCH_BATCH_MEMBERS, BENCH_BATCH_BOOKS, BENCH_BATCH_BOOKS / 4, random);
+        cout<<"batch ("<<(useSparse ? "sparse" : "dense")<<"): "<<BENCH_BATCH_MEMBERS<<" members x ";
+        cout<<BENCH_BATCH_BOOKS<<" books, about a quarter rated, "<<BENCH_BATCH_LIMIT<<" books each\n";
+
+        // The batch pass must give the exact neighbours even with the approximate search on
+        ratings.setThreadCount(BENCH_CHECK_THREADS);
+        ratings.setApproximateSearch(LSH_DEFAULT_TABLES, LSH_DEFAULT_BITS);
+        BatchRecommendations checked = ratings.recommendForAll(BENCH_BATCH_MEMBERS, BENCH_BATCH_LIMIT);
+        ratings.setApproximateSearch(0, LSH_DEFAULT_BITS);
+        if(!sameAsSingle(ratings, checked, BENCH_BATCH_MEMBERS, BENCH_BATCH_LIMIT)){
+            cout<<"  MISMATCH between the batch pass on "<<BENCH_CHECK_THREADS<<" threads and recomendBook\n";
+            ok = false;
+        }
+
+        ratings.setThreadCount(1);
+        ScratchArena arena;
+        double single = timeRun([&](){
+            for(int m = 0 ; m<BENCH_BATCH_MEMBERS ; m++){
+                arena.reset();
+                benchSink += ratings.recomendBook(m, BENCH_BATCH_LIMIT, arena).count;
+            }
+        });
+        double batch = timeRun([&](){
+            benchSink += ratings.recommendForAll(BENCH_BATCH_MEMBERS, BENCH_BATCH_LIMIT).bookIds.size();
+        });
+        cout<<"  one thread, per member: "<<BENCH_BATCH_MEMBERS / single<<" members/s\n";
+        cout<<"  one thread, batch pass: "<<BENCH_BATCH_MEMBERS / batch<<" members/s\n";
+    }
+    return ok;
+}
+
+// Function to rank the books the neighbour rated and the user did not by reading every cell of both rows
+int rankByCells(const RatingList& ratings, int user, int neighbour, int books, int* ranked, int limit,
+                vector<pair<int, int>>& candidates){
+    candidates.clear();
+    for(int j = 0 ; j<books ; j++){
+        if(ratings.getRating(user, j) == 0 && ratings.getRating(neighbour, j) != 0){
+            candidates.push_back(make_pair(-ratings.getRating(neighbour, j), -j));
+        }
+    }
+
+    // Best rated first, higher book id first within a rating, as the bucket pass fills them
+    int count = min(limit, (int)candidates.size());
+    partial_sort(candidates.begin(), candidates.begin() + count, candidates.end());
+    for(int k = 0 ; k<count ; k++){
+        ranked[k] = -candidates[k].second;
+    }
+    return count;
+}
+
+// Function to time candidate ranking and co-rated counts with the bitsets and cell by cell
+bool benchBits(){
+    mt19937 random(13);
+    RatingList ratings(BENCH_BITS_MEMBERS, BENCH_BITS_BOOKS);
+    fillRatingList(ratings, BENCH_BITS_MEMBERS, BENCH_BITS_BOOKS, BENCH_BITS_RATINGS, random);
+    cout<<"bits: "<<BENCH_BITS_MEMBERS<<" members x "<<BENCH_BITS_BOOKS<<" books, ";
+    cout<<BENCH_BITS_RATINGS<<" ratings each, "<<BENCH_BITS_USERS<<" users timed\n";
+
+    // Every timed user is paired with the next member as its neighbour
+    bool ok = true;
+    vector<int> fast(BENCH_BITS_BOOKS), slow(BENCH_BITS_BOOKS), candidates;
+    vector<pair<int, int>> cells;
+    for(int u = 0 ; u<BENCH_BITS_USERS ; u++){
+        int found = ratings.rankUnratedBooks(u, u + 1, fast.data(), BENCH_BITS_BOOKS, candidates);
+        int expected = rankByCells(ratings, u, u + 1, BENCH_BITS_BOOKS, slow.data(), BENCH_BITS_BOOKS, cells);
+        int shared = 0;
+        for(int j = 0 ; j<BENCH_BITS_BOOKS ; j++){
+            shared += ratings.getRating(u, j) != 0 && ratings.getRating(u + 1, j) != 0;
+        }
+        if(found != expected || !equal(fast.begin(), fast.begin() + found, slow.begin()) ||
+           ratings.coRatedCount(u, u + 1) != shared){
+            ok = false;
+        }
+    }
+    if(!ok){
+        cout<<"  MISMATCH between the bitsets and the cells\n";
+    }
+
+    double bitRank = timeRun([&](){
+        for(int u = 0 ; u<BENCH_BITS_USERS ; u++){
+            benchSink += ratings.rankUnratedBooks(u, u + 1, fast.data(), BENCH_BITS_BOOKS, candidates);
+        }
+    });
+    double cellRank = timeRun([&](){
+        for(int u = 0 ; u<BENCH_BITS_USERS ; u++){
+            benchSink += rankByCells(ratings, u, u + 1, BENCH_BITS_BOOKS, slow.data(), BENCH_BITS_BOOKS, cells);
+        }
+    });
+    double bitCount = timeRun([&](){
+        for(int u = 0 ; u<BENCH_BITS_USERS ; u++){
+            benchSink += ratings.coRatedCount(u, u + 1);
+        }
+    });
+    double cellCount = timeRun([&](){
+        for(int u = 0 ; u<BENCH_BITS_USERS ; u++){
+            for(int j = 0 ; j<BENCH_BITS_BOOKS ; j++){
+                benchSink += ratings.getRating(u, j) != 0 && ratings.getRating(u + 1, j) != 0;
+            }
+        }
+    });
+    ratings.setThreadCount(1);
+    ScratchArena arena;
+    double recommend = timeRun([&](){
+        for(int u = 0 ; u<BENCH_BITS_USERS ; u++){
+            arena.reset();
+            benchSink += ratings.recomendBook(u, arena).count;
+        }
+    });
+    cout<<"  candidate ranking: "<<bitRank / BENCH_BITS_USERS * 1e6<<" us per user with bitsets, ";
+    cout<<cellRank / BENCH_BITS_USERS * 1e6<<" us cell by cell\n";
+    cout<<"  co-rated count: "<<bitCount / BENCH_BITS_USERS * 1e6<<" us per pair with bitsets, ";
+    cout<<cellCount / BENCH_BITS_USERS * 1e6<<" us cell by cell\n";
+    cout<<"  full recommendation, one thread: "<<recommend / BENCH_BITS_USERS * 1e3<<" ms per user\n";
+    return ok;
+}
+
+// Function to check that recommendations from one arena, reset before each, take no heap blocks once
+// the first round has sized the arena
+bool benchArena(){
+    cout<<"arena: "<<BENCH_ARENA_USERS<<" recommendations per round, "<<BENCH_ARENA_ROUNDS;
+    cout<<" rounds after the first\n";
+
+    // Half the books are drawn for every member, so the dense search scans the rows on the pool rather
+    // than going through the rater index
+    bool ok = true;
+    for(bool useSparse : {false, true}){
+        mt19937 random(22);
+        RatingList ratings(BENCH_BATCH_MEMBERS, BENCH_BATCH_BOOKS, useSparse);
+        fillRatingList(ratings, BENCH_BATCH_MEMBERS, BENCH_BATCH_BOOKS, BENCH_BATCH_BOOKS / 2, random);
+        for(int threads : {1, BENCH_CHECK_THREADS}){
+            ratings.setThreadCount(threads);
+            ScratchArena arena;
+            long long warm = 0;
+            for(int round = 0 ; round<=BENCH_ARENA_ROUNDS ; round++){
+                for(int u = 0 ; u<BENCH_ARENA_USERS ; u++){
+                    arena.reset();
+                    benchSink += ratings.recomendBook(u, arena).count;
+                }
+                if(round == 0){
+                    warm = arena.getHeapBlocks();
+                }
+            }
+            cout<<"  "<<(useSparse ? "sparse" : "dense")<<", "<<threads<<" threads: "<<warm;
+            cout<<" heap blocks after the first round, "<<arena.getHeapBlocks()<<" after the last";
+            if(arena.getHeapBlocks() != warm){
+                cout<<"  MISMATCH";
+                ok = false;
+            }
+            cout<<"\n";
+        }
+    }
+    return ok;
+}
+
+// Function to give every member of a rating list the ratings of a random taste group: perMember ratings
+// drawn from the group's shelf with the group's sign for every book, and randomRatings anywhere
+void fillTasteGroups(RatingList& ratings, int members, int books, int perMember, int randomRatings, mt19937& random){
+    uniform_int_distribution<int> group(0, BENCH_LSH_GROUPS - 1);
+    uniform_int_distribution<int> shelfBook(0, BENCH_LSH_SHELF - 1);
+    uniform_int_distribution<int> book(0, books - 1);
+    uniform_int_distribution<int> value(1, 5);
+    vector<int> shelf(BENCH_LSH_GROUPS * BENCH_LSH_SHELF);
+    for(int& b : shelf){
+        b = book(random);
+    }
+    for(int m = 0 ; m<members ; m++){
+        int g = group(random);
+        for(int k = 0 ; k<perMember ; k++){
+            int b = shelf[g * BENCH_LSH_SHELF + shelfBook(random)];
+            ratings.setRating(m, b, (b + g) % 3 == 0 ? -value(random) : value(random));
+        }
+        for(int k = 0 ; k<randomRatings ; k++){
+            ratings.setRating(m, book(random), value(random) - 3);
+        }
+    }
+}
+
+// Function to measure the recall@1 and the time per query of the approximate search for a few hash
+// settings against the exact search. A member whose buckets hold no positive candidate falls back to the
+// exact search and counts as a hit, so with many bits recall climbs again while the time nears the exact one.
+bool benchLsh(){
+    mt19937 random(12);
+    RatingList ratings(BENCH_LSH_MEMBERS, BENCH_LSH_BOOKS, true);
+    fillTasteGroups(ratings, BENCH_LSH_MEMBERS, BENCH_LSH_BOOKS, BENCH_LSH_RATINGS, BENCH_LSH_RANDOM, random);
+    ratings.setThreadCount(1);
+    cout<<"lsh: "<<BENCH_LSH_MEMBERS<<" members x "<<BENCH_LSH_BOOKS<<" books (sparse), ";
+    cout<<BENCH_LSH_GROUPS<<" taste groups, "<<BENCH_LSH_RATINGS + BENCH_LSH_RANDOM<<" ratings each, ";
+    cout<<BENCH_LSH_USERS<<" members timed, one thread\n";
+
+    // A query is a recommendation of one book, so the time is almost all neighbour search
+    ScratchArena arena;
+    auto queries = [&](){
+        for(int u = 0 ; u<BENCH_LSH_USERS ; u++){
+            arena.reset();
+            benchSink += ratings.recomendBook(u * (BENCH_LSH_MEMBERS / BENCH_LSH_USERS), 1, arena).similarUser;
+        }
+    };
+    double exact = timeRun(queries);
+    cout<<"  exact search: "<<exact / BENCH_LSH_USERS * 1e6<<" us per query\n";
+
+    const int settings[][2] = {{4, 8}, {8, 8}, {8, 12}, {16, 12}, {8, 16}, {16, 16}};
+    for(const int* setting : settings){
+        ratings.setApproximateSearch(setting[0], setting[1]);
+        double recall = ratings.recallAtOne(BENCH_LSH_MEMBERS, BENCH_LSH_USERS);
+        double approximate = timeRun(queries);
+        cout<<"  "<<setting[0]<<" tables x "<<setting[1]<<" bits: recall@1 "<<recall<<", ";
+        cout<<approximate / BENCH_LSH_USERS * 1e6<<" us per query ("<<exact / approximate<<"x the exact search)\n";
+    }
+    ratings.setApproximateSearch(0, LSH_DEFAULT_BITS);
+    return true;
+}
+
+// Main function
+int main(int argc, char** argv){
+    string which = argc > 1 ? argv[1] : "all";
+    bool ok = true;
+    bool ran = false;
+    if(which == "all" || which == "kernels"){
+        ok = benchKernels() && ok;
+        ran = true;
+    }
+    if(which == "all" || which == "batch"){
+        ok = benchBatch() && ok;
+        ran = true;
+    }
+    if(which == "all" || which == "bits"){
+        ok = benchBits() && ok;
+        ran = true;
+    }
+    if(which == "all" || which == "arena"){
+        ok = benchArena() && ok;
+        ran = true;
+    }
+    if(which == "all" || which == "lsh"){
+        ok = benchLsh() && ok;
+        ran = true;
+    }
+    if(!ran){
+        cout<<"Unknown benchmark "<<which<<"\n";
+        return 2;
+    }
+    return ok ? 0 : 1;
+}
@@ -10,28 +10,38 @@
 // PURPOSE: This program defines a struct for representing a book and a class for managing a list of books.
 // INPUT:   None directly from the user. The program can be extended to accept user input for adding books.
 // PROCESS: The program defines a Book struct to represent individual books and a BookList class to manage
-// a list of books.The BookList class provides methods to add books to the list, resize the array dynamically,
-// and retrieve the book array pointer.
+// a list of books.The BookList class provides methods to add books to the list, one at a time or in bulk,
+// and to read and replace a book by index. A Book holds handles into the string pool instead of strings, so
+// it is copied with memcpy and reading one allocates nothing. The list keeps each field in its own array
+// (a ColumnStore), which grows by moving its elements. Every book is also kept in a hash table (a
+// HashIndex) by its key: author, title and year, with the text lower-cased, apostrophes dropped and every
+// run of spaces and punctuation read as one space, so findBook tells in O(1) whether a book is already in
+// the list.
 // OUTPUT:  None directly returned by the program. The program can be extended to output information
 // about the books stored in the list.
 #include<iostream>
 #include<string>
+#include<vector>
+#include<cstdint>
+#include "StringPool.h"
+#include "ColumnStore.h"
+#include "HashIndex.h"
 
 
 using namespace std;
 
-// Struct for representing a book
+// Struct for representing a book (plain data; the strings live in the shared string pool)
 struct Book{
 
     int ISBN;  // Unique identifier for the book
-    string Author;  // Name of the author
-    string Title;  // Title of the book
+    PooledString Author;  // Name of the author
+    PooledString Title;  // Title of the book
     int Year;  // Year of publication
     int introducer;  // ID of the user who introduced the book
 
 
     // Constructor to initialize all attributes of the book
-    Book(int _ISBN, string _Author, string _Title, int _Year, int _introducer ){
+    Book(int _ISBN, PooledString _Author, PooledString _Title, int _Year, int _introducer ){
         ISBN = _ISBN;
         Author = _Author;
         Title = _Title;
@@ -49,33 +59,89 @@ struct Book{
 class BookList{
 private:
 
-    Book* bookArray;  // Pointer to an array of books
-    int capacity;  // Capacity of the array
-    int countBooks=0;  // Number of books currently in the array
+    // Fields of every book, one array each: ISBN, author, title, year, introducer
+    ColumnStore<int, PooledString, PooledString, int, int> books;
+    HashIndex keys;  // Books by the hash of their key
 
-public:
+    // Method to lower-case a text, drop apostrophes and turn every run of other characters into one space
+    static string normalize(PooledString text);
+
+    // Method to add the normalized bytes of a text to a hash, without building the normalized text
+    static uint64_t hashWords(uint64_t hash, PooledString text);
 
+    // Method to get the hash of a book's key
+    static uint64_t keyOf(PooledString Author, PooledString Title, int Year);
 
-    // Constructor to initialize the book array with a specified initial capacity
-    BookList(int initialCapacity){
-        bookArray = new Book[initialCapacity];
-        capacity = initialCapacity;
+    // Method to check whether the book at an index has the given key
+    bool sameKey(int i, PooledString Author, PooledString Title, int Year) const;
+
+public:
 
+
+    // Constructor to initialize the book list with room for a specified initial number of books
+    BookList(int initialCapacity) : books(initialCapacity){
     }
 
-    // Destructor to deallocate memory for the book array
-    ~BookList(){
-        delete[] bookArray;
+    // Method to get a copy of the book at an index
+    Book getBook(int i) const{
+        return Book(books.at<0>(i), books.at<1>(i), books.at<2>(i), books.at<3>(i), books.at<4>(i));
     }
 
-    // Method to get the pointer to the book array
-    Book* getBookArray();
+    // Method to replace the book at an index
+    void setBook(int i, const Book& b);
+
+    // Method to get the number of books in the list
+    int getCount() const{
+        return books.size();
+    }
 
-    // Method to resize the book array when it reaches capacity
-    void resizeArray();
+    // Method to grow the book list (and its key table) to hold at least n books in one step
+    void reserve(int n){
+        books.reserve(n);
+        keys.reserve(n);
+    }
 
     // Method to add a new book to the list
-    void addBook(string Author, string Title, int Year, int loggedInUser);
+    void addBook(PooledString Author, PooledString Title, int Year, int loggedInUser);
+
+    // Method to add n books at once, book i given by make(i); ISBNs follow on from the list
+    template<typename Make>
+    void addBooks(int n, Make make){
+        vector<uint64_t> hashes(n);
+        addBooks(n, [&](int i){
+            Book b = make(i);
+            hashes[i] = keyOf(b.Author, b.Title, b.Year);
+            return b;
+        }, [&](int i){
+            return hashes[i];
+        });
+    }
+
+    // Method to add n books at once whose key hashes are known already (book i given by make(i), the hash
+    // of its key by keyHash(i), called after every book was made), such as books read from a snapshot
+    template<typename Make, typename KeyHash>
+    void addBooks(int n, Make make, KeyHash keyHash){
+        int first = books.size();
+        books.appendRows(n, [&](int i){
+            Book b = make(i);
+            return make_tuple(first + i + 1, b.Author, b.Title, b.Year, b.introducer);
+        });
+
+        // The books go in the key table in a loop of their own, so its cache misses overlap
+        keys.reserve(first + n);
+        for(int i = 0 ; i<n ; i++){
+            keys.insert(first + i, keyHash(i));
+        }
+    }
+
+    // Method to get the hash of the key of the book at an index
+    uint64_t keyHash(int i) const{
+        return keys.hashOf(i);
+    }
+
+    // Method to find the first book with the same author, title and year (ignoring case, spaces and
+    // punctuation), returning its index or -1 if there is none
+    int findBook(PooledString Author, PooledString Title, int Year) const;
 
 
 };
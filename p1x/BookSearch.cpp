@@ -0,0 +1,466 @@
+
+// AUTHOR: Shikha Pallavi
+// PROGRAM: BookSearch.cpp
+// DATE: 10/16/2026
+
+// PURPOSE: This file contains the implementation of the title and author search.
+
+// INPUT: build takes the book list, the number of books to index and the pool to build on; addBook
+// takes a new book. search takes the words typed and the number of results wanted.
+
+// PROCESS: build gives every part of the pool a range of books; a part cuts its books into words and
+// collects, for every word it saw, its books in order. The parts' words are then added to the index one
+// part after the other, so every term's books stay in book order, and the terms are sorted once at the end
+// (addBook inserts a new term in its place). A query word's prefix matches are the run of sorted terms
+// from the first one not below the word. For the near misses, walkTerms follows the sorted terms one
+// letter deeper at a time, narrowing the range to the terms with that letter next and adding a row of the
+// edit distance table of the query word against the letters so far; once a row is all over the limit the
+// range is dropped, or taken whole if the end of the word was already reached within it. matchBooks reads
+// the terms' lists in blocks of books, one query word at a time with one bit per word, adding up for every
+// book the best score of each word, and keeps a book when every word's bit is set. Each term's list keeps
+// a cursor, so every block carries on where the last one stopped, and matching stops after the block where
+// n books reach the best total.
+
+// OUTPUT: search returns the matching books with their scores, best first.
+
+#include<iostream>
+#include<string>
+#include<algorithm>
+#include "BookSearch.h"
+
+
+using namespace std;
+
+// Function to get the number of edits a query word of n characters is allowed in the second pass
+static int editsAllowed(size_t n){
+    if(n >= SEARCH_FUZZY_TWO) return 2;
+    if(n >= SEARCH_FUZZY_ONE) return 1;
+    return 0;
+}
+
+// Function to order search results by score, then by lower book id
+static bool betterResult(const BookScore& a, const BookScore& b){
+    if(a.score != b.score){
+        return a.score > b.score;
+    }
+    return a.book < b.book;
+}
+
+// Method to lower-case a text and cut it into words, written one after the other into words,
+// each followed by a space
+void BookSearch::normalize(const char* text, size_t n, string& words){
+    bool inWord = false;
+    for(size_t i = 0 ; i<n ; i++){
+        char c = text[i];
+        if(c >= 'A' && c <= 'Z'){
+            c = c - 'A' + 'a';
+        }
+        if((c >= 'a' && c <= 'z') || (c >= '0' && c <= '9')){
+            words += c;
+            inWord = true;
+        }
+
+        // An apostrophe joins the two halves of the word ("Hitchhiker's" is one word)
+        else if(c != '\'' && inWord){
+            words += ' ';
+            inWord = false;
+        }
+    }
+    if(inWord){
+        words += ' ';
+    }
+}
+
+// Method to append the distinct words of a book to found as (word, 1 if in the title)
+void BookSearch::bookWords(const Book& b, string& words, vector<pair<string, int>>& found){
+    words.clear();
+    normalize(b.Title.data(), b.Title.size(), words);
+    size_t titleEnd = words.size();
+    normalize(b.Author.data(), b.Author.size(), words);
+    size_t first = found.size();
+    size_t start = 0;
+    for(size_t i = 0 ; i<words.size() ; i++){
+        if(words[i] == ' '){
+            found.push_back(make_pair(words.substr(start, i - start), start < titleEnd ? 1 : 0));
+            start = i + 1;
+        }
+    }
+
+    // A word in both the title and the author is kept once, as a title word
+    sort(found.begin() + first, found.end(), [](const pair<string, int>& x, const pair<string, int>& y){
+        return x.first != y.first ? x.first < y.first : x.second > y.second;
+    });
+    found.erase(unique(found.begin() + first, found.end(), [](const pair<string, int>& x, const pair<string, int>& y){
+        return x.first == y.first;
+    }), found.end());
+}
+
+// Method to get the ID of a term, adding it if it is new (the caller puts new terms in word order)
+int BookSearch::termId(const string& word){
+    auto it = termIds.find(word);
+    if(it != termIds.end()){
+        return it->second;
+    }
+    int id = (int)terms.size();
+    terms.push_back(word);
+    termIds.emplace(word, id);
+    termBooks.emplace_back();
+    return id;
+}
+
+// Method to order the term IDs by their words
+void BookSearch::sortTerms(){
+    sortedTerms.resize(terms.size());
+    for(int t = 0 ; t<(int)terms.size() ; t++){
+        sortedTerms[t] = t;
+    }
+    sort(sortedTerms.begin(), sortedTerms.end(), [&](int a, int b){
+        return terms[a] < terms[b];
+    });
+}
+
+// Method to index the first count books of the list, replacing what was indexed, with the work split
+// over the pool or done here if it is null
+void BookSearch::build(const BookList& books, int count, ThreadPool* pool){
+    terms.clear();
+    termIds.clear();
+    termBooks.clear();
+
+    // Every part cuts its range of books into words, keeping the books of every word in order
+    int parts = pool ? max(1, min((count + SEARCH_PART_BOOKS - 1) / SEARCH_PART_BOOKS, 4 * pool->size())) : 1;
+    vector<vector<string>> partWords(parts);
+    vector<vector<vector<int>>> partBooks(parts);
+    auto indexRange = [&](int part){
+        int first = (int)((long long)count * part / parts);
+        int last = (int)((long long)count * (part + 1) / parts);
+        unordered_map<string, int> ids;
+        vector<pair<string, int>> found;
+        string words;
+        for(int i = first ; i<last ; i++){
+            found.clear();
+            bookWords(books.getBook(i), words, found);
+            for(const pair<string, int>& w : found){
+                auto it = ids.find(w.first);
+                int id;
+                if(it == ids.end()){
+                    id = (int)partWords[part].size();
+                    ids.emplace(w.first, id);
+                    partWords[part].push_back(w.first);
+                    partBooks[part].emplace_back();
+                }
+                else{
+                    id = it->second;
+                }
+                partBooks[part][id].push_back(i * 2 + w.second);
+            }
+        }
+    };
+    if(pool){
+        pool->run(parts, indexRange);
+    }
+    else{
+        indexRange(0);
+    }
+
+    // The parts cover the books in order, so appending their lists part by part keeps every list in order
+    for(int part = 0 ; part<parts ; part++){
+        for(size_t k = 0 ; k<partWords[part].size() ; k++){
+            vector<int>& list = termBooks[termId(partWords[part][k])];
+            list.insert(list.end(), partBooks[part][k].begin(), partBooks[part][k].end());
+        }
+        partWords[part].clear();
+        partBooks[part].clear();
+    }
+    sortTerms();
+    numBooks = count;
+}
+
+// Method to index a book added at the end of the list
+void BookSearch::addBook(int book, const Book& b){
+    vector<pair<string, int>> found;
+    string words;
+    bookWords(b, words, found);
+    for(const pair<string, int>& w : found){
+        int t = termId(w.first);
+        termBooks[t].push_back(book * 2 + w.second);
+
+        // A new term goes in its place in word order
+        if(t == (int)sortedTerms.size()){
+            auto at = lower_bound(sortedTerms.begin(), sortedTerms.end(), w.first, [&](int a, const string& word){
+                return terms[a] < word;
+            });
+            sortedTerms.insert(at, t);
+        }
+    }
+    numBooks = book + 1;
+}
+
+// Method to score a term that is d edits from starting with a query word of n letters
+static int termScore(int d, size_t termLength, size_t n){
+
+    // A whole word beats the start of a word, which beats a near miss
+    if(d == 0){
+        return termLength == n ? 4 : 3;
+    }
+    return 3 - d;
+}
+
+// Method to add every term of sortedTerms[first, last) to matches as d edits from the query word
+void BookSearch::addTerms(int first, int last, int d, size_t n, vector<TermMatch>& matches) const{
+    for(int k = first ; k<last ; k++){
+        int t = sortedTerms[k];
+        matches.push_back({t, termScore(d, terms[t].size(), n)});
+    }
+}
+
+// Method to find, among sortedTerms[first, last), the end of the terms with letter c at position depth
+int BookSearch::letterEnd(int first, int last, size_t depth, char c) const{
+    while(first < last){
+        int middle = first + (last - first) / 2;
+        if(terms[sortedTerms[middle]][depth] <= c){
+            first = middle + 1;
+        }
+        else{
+            last = middle;
+        }
+    }
+    return first;
+}
+
+// Method to find the terms within edits of starting with the query word among sortedTerms[first, last),
+// which all share their first depth letters, given the distance table's rows for those letters and the
+// fewest edits (best) to any shorter start of them
+void BookSearch::walkTerms(const string& word, int edits, size_t depth, int first, int last, int best,
+                           vector<TermMatch>& matches){
+    size_t n = word.size();
+    size_t width = n + 1;
+
+    // Terms are sorted, so the one ending here (if any) comes first and was scored by the caller
+    if(first < last && terms[sortedTerms[first]].size() == depth){
+        first++;
+    }
+    while(first < last){
+        const string& head = terms[sortedTerms[first]];
+        char c = head[depth];
+        int end = letterEnd(first, last, depth, c);
+
+        // The next row of the table: the query's starts against the terms' first depth + 1 letters, a swap
+        // of two neighbouring letters counting as one edit
+        const int* previous = &distance[depth * width];
+        const int* older = depth > 0 ? previous - width : nullptr;
+        int* current = &distance[(depth + 1) * width];
+        current[0] = (int)depth + 1;
+        int rowBest = current[0];
+        for(size_t i = 1 ; i<=n ; i++){
+            int cost = previous[i-1] + (word[i-1] != c);
+            cost = min(cost, min(previous[i], current[i-1]) + 1);
+            if(older && i > 1 && word[i-1] == head[depth-1] && word[i-2] == c){
+                cost = min(cost, older[i-2] + 1);
+            }
+            current[i] = cost;
+            rowBest = min(rowBest, cost);
+        }
+        int reached = min(best, current[n]);
+
+        // Once every entry of the row is over the limit no longer start gets closer, so the whole range
+        // matches as well as its shortest start does
+        if(rowBest > edits){
+            if(reached <= edits){
+                addTerms(first, end, reached, n, matches);
+            }
+        }
+        else{
+            if(reached <= edits && terms[sortedTerms[first]].size() == depth + 1){
+                addTerms(first, first + 1, reached, n, matches);
+            }
+            walkTerms(word, edits, depth + 1, first, end, reached, matches);
+        }
+        first = end;
+    }
+}
+
+// Method to find the terms a query word matches, exactly, as a prefix or within the edits allowed
+void BookSearch::matchTerms(const string& word, int edits, vector<TermMatch>& matches){
+
+    // The terms starting with the word are one run of the sorted terms
+    if(edits == 0){
+        auto first = lower_bound(sortedTerms.begin(), sortedTerms.end(), word, [&](int t, const string& w){
+            return terms[t] < w;
+        });
+        auto last = first;
+        while(last != sortedTerms.end() && terms[*last].compare(0, word.size(), word) == 0){
+            last++;
+        }
+        addTerms((int)(first - sortedTerms.begin()), (int)(last - sortedTerms.begin()), 0, word.size(), matches);
+        return;
+    }
+
+    // Otherwise the sorted terms are walked as a trie, one row of the distance table per letter, leaving
+    // every branch as soon as its row is over the limit
+    size_t width = word.size() + 1;
+    distance.resize((word.size() + edits + 2) * width);
+    for(size_t i = 0 ; i<width ; i++){
+        distance[i] = (int)i;
+    }
+    walkTerms(word, edits, 0, 0, (int)sortedTerms.size(), (int)word.size(), matches);
+}
+
+// Method to find the books every query word matches through its terms, with their scores, stopping once
+// n books have the best score the words can give
+void BookSearch::matchBooks(const vector<vector<TermMatch>>& wordMatches, int n, vector<BookScore>& found){
+
+    // The word with the fewest books goes first, as only its books can match. A book scores at most the
+    // best term of every word, found in its title.
+    int numWords = (int)wordMatches.size();
+    vector<pair<long long, int>> order;
+    int bestTotal = 0;
+    for(int w = 0 ; w<numWords ; w++){
+        long long volume = 0;
+        int best = 0;
+        for(const TermMatch& m : wordMatches[w]){
+            volume += termBooks[m.term].size();
+            best = max(best, m.score << 1);
+        }
+        order.push_back(make_pair(volume, w));
+        bestTotal += best;
+    }
+    sort(order.begin(), order.end());
+
+    // Where every term's list was read up to, so each block carries on from the last one
+    vector<vector<size_t>> cursor(numWords);
+    for(int w = 0 ; w<numWords ; w++){
+        cursor[w].assign(wordMatches[w].size(), 0);
+    }
+
+    // Books are matched a block at a time, each twice as large as the one before up to SEARCH_MAX_BLOCK, so
+    // the state of the block's books stays in cache. Lists are in book order and ties go to the lower book,
+    // so once n books of the blocks read have the best total no later book can make the results, and the
+    // rest of the lists is never read.
+    int bestFound = 0;
+    int blockSize = SEARCH_FIRST_BLOCK;
+    for(int blockStart = 0 ; blockStart<numBooks && bestFound<n ; blockStart += blockSize){
+        blockSize = min(2 * blockSize, SEARCH_MAX_BLOCK);
+        if(blockStart == 0){
+            blockSize = SEARCH_FIRST_BLOCK;
+        }
+        int blockEnd = (int)min((long long)numBooks, (long long)blockStart + blockSize);
+        BlockMatch* state = blockMatches.data() - blockStart;
+
+        // A book's bits say which words matched it so far; a word only counts for books all earlier words matched
+        for(int k = 0 ; k<numWords ; k++){
+            uint32_t bit = 1u << k;
+            uint32_t before = bit - 1;
+            const vector<TermMatch>& matches = wordMatches[order[k].second];
+            vector<size_t>& at = cursor[order[k].second];
+
+            // When the word's lists are much longer than the books still in the running, each of those books
+            // is looked up in them by binary search instead of reading them through
+            long long probes = (long long)reachedBooks.size() * matches.size() * SEARCH_PROBE_COST;
+            if(k > 0 && probes < order[k].first * (blockEnd - blockStart) / numBooks){
+                for(int book : reachedBooks){
+                    if(state[book].mask != before) continue;
+                    int best = 0;
+                    for(size_t j = 0 ; j<matches.size() ; j++){
+                        const vector<int>& list = termBooks[matches[j].term];
+                        auto it = lower_bound(list.begin() + at[j], list.end(), book * 2);
+                        if(it != list.end() && (*it >> 1) == book){
+                            best = max(best, matches[j].score << (*it & 1));
+                        }
+                    }
+                    if(best > 0){
+                        state[book].mask = before | bit;
+                        state[book].score += best;
+                    }
+                }
+                continue;
+            }
+
+            for(size_t j = 0 ; j<matches.size() ; j++){
+                const vector<int>& list = termBooks[matches[j].term];
+                int value = matches[j].score;
+
+                // A list skipped by the binary searches of an earlier block starts before this block
+                size_t e = at[j];
+                if(e < list.size() && list[e] < blockStart * 2){
+                    e = lower_bound(list.begin() + e, list.end(), blockStart * 2) - list.begin();
+                }
+                for( ; e<list.size() && list[e] < blockEnd * 2 ; e++){
+                    int book = list[e] >> 1;
+                    int entryValue = value << (list[e] & 1);
+                    BlockMatch& m = state[book];
+                    if(m.mask == before){
+                        if(k == 0){
+                            reachedBooks.push_back(book);
+                            m.score = 0;
+                        }
+                        m.mask = before | bit;
+                        m.best = entryValue;
+                        m.score += entryValue;
+                    }
+                    else if(m.mask == (before | bit) && entryValue > m.best){
+                        m.score += entryValue - m.best;
+                        m.best = entryValue;
+                    }
+                }
+                at[j] = e;
+            }
+        }
+
+        // Keep the books every word matched and leave the bits zeroed for the next block
+        uint32_t all = numWords == 32 ? 0xFFFFFFFFu : (1u << numWords) - 1;
+        for(int book : reachedBooks){
+            if(state[book].mask == all){
+                found.push_back({book, state[book].score});
+                bestFound += state[book].score == bestTotal;
+            }
+            state[book].mask = 0;
+        }
+        reachedBooks.clear();
+    }
+}
+
+// Method to find the books matching every query word, exactly or as a prefix or (fuzzy) nearly
+void BookSearch::searchPass(const vector<string>& queryWords, bool fuzzy, int n, vector<BookScore>& found){
+    vector<vector<TermMatch>> wordMatches(queryWords.size());
+    for(size_t w = 0 ; w<queryWords.size() ; w++){
+        matchTerms(queryWords[w], fuzzy ? editsAllowed(queryWords[w].size()) : 0, wordMatches[w]);
+        if(wordMatches[w].empty()){
+            return;
+        }
+    }
+    matchBooks(wordMatches, n, found);
+}
+
+// Method to find up to n books matching the words of a query, best first
+vector<BookScore> BookSearch::search(string query, int n){
+    vector<BookScore> found;
+    string normalized;
+    normalize(query.data(), query.size(), normalized);
+    vector<string> queryWords;
+    size_t start = 0;
+    for(size_t i = 0 ; i<normalized.size() && queryWords.size()<SEARCH_MAX_WORDS ; i++){
+        if(normalized[i] == ' '){
+            queryWords.push_back(normalized.substr(start, i - start));
+            start = i + 1;
+        }
+    }
+    if(queryWords.empty() || n <= 0 || numBooks == 0){
+        return found;
+    }
+
+    // Near misses are only looked for when the words themselves match too few books
+    searchPass(queryWords, false, n, found);
+    bool canEdit = false;
+    for(const string& q : queryWords){
+        canEdit = canEdit || editsAllowed(q.size()) > 0;
+    }
+    if((int)found.size() < n && canEdit){
+        found.clear();
+        searchPass(queryWords, true, n, found);
+    }
+
+    int shown = min(n, (int)found.size());
+    partial_sort(found.begin(), found.begin() + shown, found.end(), betterResult);
+    found.resize(shown);
+    return found;
+}
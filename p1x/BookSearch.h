@@ -0,0 +1,166 @@
+//
+// Created by Shikha Pallavi on 10/16/26.
+//
+
+#ifndef P1X_BOOKSEARCH_H
+#define P1X_BOOKSEARCH_H
+
+// AUTHOR: Shikha Pallavi
+// PROGRAM: BookSearch.h
+// DATE: 10/16/2026
+// PURPOSE: Header file for searching the books by words of their title and author.
+// INPUT: None directly from the user. The session passes the book list, the words typed and the number
+// of results wanted.
+// PROCESS: Titles and authors are normalized to lower-case letters and digits, everything else splitting
+// words. Every distinct word (a term) keeps the sorted list of books it appears in, each marked with
+// whether it is in the title, and the terms are also kept in alphabetical order. A query word matches a
+// term that starts with it, which is a range of the sorted terms, or, in a second pass run when too few
+// books match, one that starts with something at most a few edits away from it (1 edit from
+// SEARCH_FUZZY_ONE letters, 2 from SEARCH_FUZZY_TWO, a swap of two neighbouring letters counting as one).
+// Those are found by walking the sorted terms as a tree of shared first letters, one row of the edit
+// distance table per letter, leaving a branch once its row is over the limit (taking all of it if the end
+// of the query word was reached within the limit on the way). The books are then matched a block at a
+// time, rarest query word first, keeping only the books every query word matched; a later word whose lists
+// are far longer than the books left is looked up for each of those books by binary search. Exact words
+// rank above prefixes, prefixes above near misses, and title words count twice as much as author words.
+// Once n books have the best score the query words allow, the rest of the lists is not read. The index is
+// built at load on the rating list's thread pool, one range of books per part, and a new book is added to
+// it in place.
+// Measured on 1,000,000 synthetic titles (86,183 terms) on one core: one word 0.03 ms, two title words
+// 0.4 ms (median 0.04 ms), but a title word with a surname 2.0 ms, with a surname prefix 2.6 ms and with
+// a misspelt surname 1.8 ms, so the sub-millisecond target is met for single words and most title-only
+// queries but missed on average once an author word is in the query. The miss comes from query words
+// that are the start of hundreds of terms: any of those terms found in a title would outrank the whole
+// word found in an author, so no book reaches the best score the words allow and all of their lists (tens
+// of thousands of books) are read; a misspelt word also costs the second pass. The build took 2.6 s
+// without a pool and 4.3 s on a pool of 4 threads sharing the one core (0.6 s of that is merging the
+// parts); how it scales on more cores was not measured.
+// OUTPUT: None directly. search returns the matching books, best first.
+
+#include<iostream>
+#include<string>
+#include<vector>
+#include<unordered_map>
+#include<cstdint>
+#include "BookList.h"
+#include "RatingList.h"
+#include "ThreadPool.h"
+
+// Shortest query words allowed one and two edits in the second pass
+#define SEARCH_FUZZY_ONE 4
+#define SEARCH_FUZZY_TWO 8
+
+// Query words looked at (one bit each while the books are matched)
+#define SEARCH_MAX_WORDS 32
+
+// Rough cost of looking a book up in a term's list, in books read, used to choose between the two
+#define SEARCH_PROBE_COST 24
+
+// Books matched in the first block of a search, and the most in any block (every later block is twice
+// as large as the one before, up to the most)
+#define SEARCH_FIRST_BLOCK 1024
+#define SEARCH_MAX_BLOCK 32768
+
+// Books per part when the index is built in parallel
+#define SEARCH_PART_BOOKS 4096
+
+
+using namespace std;
+
+// Struct for a term matched by a query word
+struct TermMatch{
+
+    int term;   // Term ID
+    int score;  // 4 for the whole word, 3 for a prefix, less for a near miss
+
+};
+
+// Struct for how a book of the block being matched stands against the query words
+struct BlockMatch{
+
+    uint32_t mask;  // Query words matched so far, one bit each
+    int best;       // Best value of the current query word
+    int score;      // Sum of the best value of every word matched
+
+};
+
+// Class for finding books by words of their title and author
+class BookSearch{
+private:
+
+    vector<string> terms;                // Every distinct word, by term ID
+    unordered_map<string, int> termIds;  // Term ID of every word
+    vector<vector<int>> termBooks;       // Books of every term as book * 2 + (1 if in the title), in book order
+    vector<int> sortedTerms;             // Term IDs in the order of their words
+    int numBooks;                        // Number of books indexed
+    vector<BlockMatch> blockMatches;     // Scratch match of every book of the block being matched (masks kept zeroed)
+    vector<int> reachedBooks;            // Scratch list of books matched by the first query word
+    vector<int> distance;                // Scratch rows of the edit distance table
+
+    // Method to lower-case a text and cut it into words, written one after the other into words,
+    // each followed by a space
+    static void normalize(const char* text, size_t n, string& words);
+
+    // Method to append the distinct words of a book to found as (word, 1 if in the title)
+    static void bookWords(const Book& b, string& words, vector<pair<string, int>>& found);
+
+    // Method to get the ID of a term, adding it if it is new (the caller puts new terms in word order)
+    int termId(const string& word);
+
+    // Method to order the term IDs by their words
+    void sortTerms();
+
+    // Method to add every term of sortedTerms[first, last) to matches as d edits from the query word
+    void addTerms(int first, int last, int d, size_t n, vector<TermMatch>& matches) const;
+
+    // Method to find, among sortedTerms[first, last), the end of the terms with letter c at position depth
+    int letterEnd(int first, int last, size_t depth, char c) const;
+
+    // Method to find the terms within edits of starting with the query word among sortedTerms[first, last),
+    // which all share their first depth letters, given the distance table's rows for those letters and the
+    // fewest edits (best) to any shorter start of them
+    void walkTerms(const string& word, int edits, size_t depth, int first, int last, int best,
+                   vector<TermMatch>& matches);
+
+    // Method to find the terms a query word matches, exactly, as a prefix or within the edits allowed
+    void matchTerms(const string& word, int edits, vector<TermMatch>& matches);
+
+    // Method to find the books every query word matches through its terms, with their scores, stopping once
+    // n books have the best score the words can give
+    void matchBooks(const vector<vector<TermMatch>>& wordMatches, int n, vector<BookScore>& found);
+
+    // Method to find the books matching every query word, exactly or as a prefix or (fuzzy) nearly, stopping
+    // once n books have the best score the words can give
+    void searchPass(const vector<string>& queryWords, bool fuzzy, int n, vector<BookScore>& found);
+
+public:
+
+    // Constructor to create an empty index
+    BookSearch(){
+        numBooks = 0;
+        blockMatches.assign(SEARCH_MAX_BLOCK, BlockMatch());
+    }
+
+    // Method to get the number of books indexed
+    int size() const{
+        return numBooks;
+    }
+
+    // Method to get the number of distinct words indexed
+    int numTerms() const{
+        return (int)terms.size();
+    }
+
+    // Method to index the first count books of the list, replacing what was indexed, with the work split
+    // over the pool (the rating list's, so the program runs one set of threads) or done here if it is null
+    void build(const BookList& books, int count, ThreadPool* pool);
+
+    // Method to index a book added at the end of the list
+    void addBook(int book, const Book& b);
+
+    // Method to find up to n books matching the words of a query, best first
+    vector<BookScore> search(string query, int n);
+
+};
+
+#endif //P1X_BOOKSEARCH_H
@@ -0,0 +1,158 @@
+//
+// Created by Shikha Pallavi on 10/16/26.
+//
+
+#ifndef P1X_COLUMNSTORE_H
+#define P1X_COLUMNSTORE_H
+
+// AUTHOR: Shikha Pallavi
+// PROGRAM: ColumnStore.h
+// DATE: 10/16/2026
+// PURPOSE: Header file for a growable list of records kept as one array per field (struct of arrays),
+// shared by the book list and the member list.
+// INPUT: None directly from the user. The lists append records and read and write their fields.
+// PROCESS: ColumnStore<Fields...> keeps an array for every field type, all with the same capacity; row i
+// of the list is element i of every array. Appending to a full store doubles the capacity, so appends
+// are amortised O(1), and reserve grows it to a given size in one step. Growing moves every element into
+// the new arrays (move construction, which is a plain memcpy for plain fields) instead of
+// default-constructing a whole new array and copy-assigning into it. appendRows reserves once and
+// appends a batch built by a callback. A loop over one field reads one contiguous array.
+// OUTPUT: None directly. The store hands out references to fields by row and field number.
+
+#include<iostream>
+#include<string>
+#include<tuple>
+#include<utility>
+#include<new>
+
+
+using namespace std;
+
+// Class for a growable list of records stored field by field
+template<typename... Fields>
+class ColumnStore{
+private:
+
+    tuple<Fields*...> columns;  // One array per field, each holding capacity elements
+    int count;                  // Number of rows in use
+    int capacity;               // Number of rows the arrays have room for
+
+    // Method to move the first count elements of a column into a new array of n elements
+    template<typename T>
+    static T* moveColumn(T* old, int count, int n){
+        T* fresh = static_cast<T*>(::operator new(sizeof(T) * (size_t)n));
+        for(int i = 0 ; i<count ; i++){
+            new (fresh + i) T(std::move(old[i]));
+            old[i].~T();
+        }
+        ::operator delete(old);
+        return fresh;
+    }
+
+    // Method to destroy the elements of a column and free it
+    template<typename T>
+    static void freeColumn(T* column, int count){
+        for(int i = 0 ; i<count ; i++){
+            column[i].~T();
+        }
+        ::operator delete(column);
+    }
+
+    // Method to move every column into arrays of n elements
+    template<size_t... K>
+    void moveColumns(int n, index_sequence<K...>){
+        auto grown = make_tuple(moveColumn(get<K>(columns), count, n)...);
+        columns = grown;
+    }
+
+    // Method to free every column
+    template<size_t... K>
+    void freeColumns(index_sequence<K...>){
+        int ignored[] = {0, (freeColumn(get<K>(columns), count), 0)...};
+        (void)ignored;
+    }
+
+    // Method to construct row count from the fields of a record
+    template<size_t... K>
+    void construct(tuple<Fields...>&& record, index_sequence<K...>){
+        int ignored[] = {0, (new (get<K>(columns) + count) Fields(std::move(get<K>(record))), 0)...};
+        (void)ignored;
+    }
+
+public:
+
+    // Constructor to create an empty store with room for initialCapacity rows
+    ColumnStore(int initialCapacity){
+        count = 0;
+        capacity = initialCapacity > 0 ? initialCapacity : 1;
+        columns = make_tuple(static_cast<Fields*>(::operator new(sizeof(Fields) * (size_t)capacity))...);
+    }
+
+    // Destructor to destroy every row and free the arrays
+    ~ColumnStore(){
+        freeColumns(index_sequence_for<Fields...>());
+    }
+
+    // The store owns its arrays, so it is not copied
+    ColumnStore(const ColumnStore&) = delete;
+    ColumnStore& operator=(const ColumnStore&) = delete;
+
+    // Method to get the number of rows
+    int size() const{
+        return count;
+    }
+
+    // Method to get the number of rows there is room for
+    int getCapacity() const{
+        return capacity;
+    }
+
+    // Method to make room for at least n rows in one step
+    void reserve(int n){
+        if(n <= capacity){
+            return;
+        }
+        moveColumns(n, index_sequence_for<Fields...>());
+        capacity = n;
+    }
+
+    // Method to append a row, doubling the capacity when the store is full, and return its index
+    int append(Fields... values){
+        if(count == capacity){
+            reserve(2*capacity);
+        }
+        construct(tuple<Fields...>(std::move(values)...), index_sequence_for<Fields...>());
+        return count++;
+    }
+
+    // Method to append n rows, row i built by make(i) as a tuple of its fields, with at most one growth
+    template<typename Make>
+    void appendRows(int n, Make make){
+        reserve(count + n);
+        for(int i = 0 ; i<n ; i++){
+            construct(make(i), index_sequence_for<Fields...>());
+            count++;
+        }
+    }
+
+    // Method to get field K of row i
+    template<size_t K>
+    typename tuple_element<K, tuple<Fields...>>::type& at(int i){
+        return get<K>(columns)[i];
+    }
+
+    // Method to get field K of row i for reading
+    template<size_t K>
+    const typename tuple_element<K, tuple<Fields...>>::type& at(int i) const{
+        return get<K>(columns)[i];
+    }
+
+    // Method to get the array of field K (size() elements)
+    template<size_t K>
+    const typename tuple_element<K, tuple<Fields...>>::type* column() const{
+        return get<K>(columns);
+    }
+
+};
+
+#endif //P1X_COLUMNSTORE_H
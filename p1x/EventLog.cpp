@@ -0,0 +1,246 @@
+
+// AUTHOR: Shikha Pallavi
+// PROGRAM: EventLog.cpp
+// DATE: 10/16/2026
+
+// PURPOSE: This file contains the implementation of the append-only change log.
+
+// INPUT: open takes the path of the log file. The add methods take the fields of one change.
+
+// PROCESS: Every change is encoded as a record (length, FNV-1a checksum, type, fields; integers in the
+// machine's byte order, strings as a length and the bytes) and added to the pending group. commit writes
+// the group with one write to the end of the file and one fdatasync, so a burst of changes costs a single
+// disk flush; if either fails, the file is cut back to its committed size so a torn group is never
+// followed by a retried copy of itself. reset cuts the file back to its tag after the session wrote a
+// snapshot holding everything.
+
+// OUTPUT: The log file. open and commit report whether the file could be used.
+
+#include<iostream>
+#include<string>
+#include<cstring>
+#include<cerrno>
+#include<sys/stat.h>
+#include<fcntl.h>
+#include<unistd.h>
+#include "EventLog.h"
+#include "Fnv.h"
+
+
+using namespace std;
+
+// Function to compute the checksum stored with every record (the 64-bit FNV-1a hash folded to 32 bits)
+uint32_t logChecksum(const char* data, uint32_t length){
+    uint64_t hash = hashBytes(data, length);
+    return (uint32_t)(hash ^ (hash >> 32));
+}
+
+// Function to add a 32-bit integer to a record
+static void putInt(string& record, int32_t value){
+    record.append((const char*)&value, 4);
+}
+
+// Function to add a string to a record as its length and its bytes
+static void putText(string& record, const string& text){
+    putInt(record, (int32_t)text.size());
+    record += text;
+}
+
+// Function to read a 32-bit integer of a record, returning false past the end
+static bool getInt(const char* data, uint32_t length, uint32_t& at, int& value){
+    if(at + 4 > length){
+        return false;
+    }
+    int32_t v;
+    memcpy(&v, data + at, 4);
+    value = v;
+    at += 4;
+    return true;
+}
+
+// Function to read a string of a record, returning false past the end
+static bool getText(const char* data, uint32_t length, uint32_t& at, string& text){
+    int size;
+    if(!getInt(data, length, at, size) || size < 0 || (uint32_t)size > length - at){
+        return false;
+    }
+    text.assign(data + at, size);
+    at += size;
+    return true;
+}
+
+// Method to open (or create) a log file, returning false (with a reason) if it cannot be used
+bool EventLog::open(string filePath, string& error){
+    close();
+    path = filePath;
+    fd = ::open(filePath.c_str(), O_RDWR | O_CREAT | O_APPEND, 0644);
+    if(fd < 0){
+        error = "cannot open " + filePath + ": " + strerror(errno);
+        return false;
+    }
+    struct stat info;
+    if(fstat(fd, &info) != 0){
+        error = "cannot read the size of " + filePath + ": " + strerror(errno);
+        close();
+        return false;
+    }
+
+    // A new log gets its tag; an old one must start with it
+    size_t tagLength = strlen(EVENT_LOG_MAGIC);
+    if(info.st_size == 0){
+        if(write(fd, EVENT_LOG_MAGIC, tagLength) != (ssize_t)tagLength || fdatasync(fd) != 0){
+            error = "cannot write " + filePath + ": " + strerror(errno);
+            close();
+            return false;
+        }
+        fileBytes = tagLength;
+        return true;
+    }
+    char tag[8];
+    if(info.st_size < (off_t)tagLength || pread(fd, tag, tagLength, 0) != (ssize_t)tagLength ||
+       memcmp(tag, EVENT_LOG_MAGIC, tagLength) != 0){
+        error = filePath + " is not a change log";
+        ::close(fd);
+        fd = -1;
+        return false;
+    }
+    fileBytes = info.st_size;
+    return true;
+}
+
+// Method to decode one record, returning false if the bytes do not form a valid record
+bool EventLog::decode(const char* data, uint32_t length, LogEvent& event){
+    if(length < 1){
+        return false;
+    }
+    event.type = (uint8_t)data[0];
+    uint32_t at = 1;
+    bool ok;
+    if(event.type == EVENT_MEMBER){
+        ok = getInt(data, length, at, event.index) && getInt(data, length, at, event.addedBy) &&
+             getText(data, length, at, event.name);
+    }
+    else if(event.type == EVENT_BOOK){
+        ok = getInt(data, length, at, event.index) && getInt(data, length, at, event.addedBy) &&
+             getInt(data, length, at, event.year) && getText(data, length, at, event.name) &&
+             getText(data, length, at, event.title);
+    }
+    else if(event.type == EVENT_RATING){
+        ok = getInt(data, length, at, event.index) && getInt(data, length, at, event.book) &&
+             getInt(data, length, at, event.rating);
+    }
+    else{
+        return false;
+    }
+    return ok && at == length && event.index >= 0;
+}
+
+// Method to add a record to the pending group and commit the group once it is due
+void EventLog::append(const string& record){
+    if(fd < 0){
+        return;
+    }
+    if(pendingCount == 0){
+        pendingSince = chrono::steady_clock::now();
+    }
+    putInt(pending, (int32_t)record.size());
+    putInt(pending, (int32_t)logChecksum(record.data(), record.size()));
+    pending += record;
+    pendingCount++;
+
+    // Commit once the group is full or its oldest record has waited long enough
+    if(pendingCount >= LOG_COMMIT_RECORDS ||
+       chrono::steady_clock::now() - pendingSince >= chrono::milliseconds(LOG_COMMIT_MS)){
+        commit();
+    }
+}
+
+// Method to log a new member
+void EventLog::addMember(int index, const string& name, int addedBy){
+    string record(1, (char)EVENT_MEMBER);
+    putInt(record, index);
+    putInt(record, addedBy);
+    putText(record, name);
+    append(record);
+}
+
+// Method to log a new book
+void EventLog::addBook(int index, const string& author, const string& title, int year, int introducer){
+    string record(1, (char)EVENT_BOOK);
+    putInt(record, index);
+    putInt(record, introducer);
+    putInt(record, year);
+    putText(record, author);
+    putText(record, title);
+    append(record);
+}
+
+// Method to log a rating
+void EventLog::addRating(int member, int book, int rating){
+    string record(1, (char)EVENT_RATING);
+    putInt(record, member);
+    putInt(record, book);
+    putInt(record, rating);
+    append(record);
+}
+
+// Method to cut off whatever part of the pending group reached the file, so the next commit writes the
+// whole group again right after the last committed record instead of after a torn one
+void EventLog::cutBack(){
+    if(ftruncate(fd, fileBytes) != 0){
+        cout<<"Error truncating "<<path<<": "<<strerror(errno)<<"\n";
+    }
+}
+
+// Method to write and sync the pending group, returning false if the file could not be written (the
+// group stays pending and the file keeps only the records committed before it)
+bool EventLog::commit(){
+    if(fd < 0 || pendingCount == 0){
+        return fd >= 0;
+    }
+    size_t written = 0;
+    while(written < pending.size()){
+        ssize_t n = write(fd, pending.data() + written, pending.size() - written);
+        if(n < 0){
+            if(errno == EINTR) continue;
+            cout<<"Error writing "<<path<<": "<<strerror(errno)<<"\n";
+            cutBack();
+            return false;
+        }
+        written += n;
+    }
+    if(fdatasync(fd) != 0){
+        cout<<"Error syncing "<<path<<": "<<strerror(errno)<<"\n";
+        cutBack();
+        return false;
+    }
+    fileBytes += pending.size();
+    pending.clear();
+    pendingCount = 0;
+    return true;
+}
+
+// Method to empty the log once everything in it is safely in a snapshot
+bool EventLog::reset(){
+    if(fd < 0){
+        return false;
+    }
+    pending.clear();
+    pendingCount = 0;
+    size_t tagLength = strlen(EVENT_LOG_MAGIC);
+    if(ftruncate(fd, tagLength) != 0 || fdatasync(fd) != 0){
+        cout<<"Error truncating "<<path<<": "<<strerror(errno)<<"\n";
+        return false;
+    }
+    fileBytes = tagLength;
+    return true;
+}
+
+// Method to commit the pending group and close the file
+void EventLog::close(){
+    if(fd >= 0){
+        commit();
+        ::close(fd);
+        fd = -1;
+    }
+}
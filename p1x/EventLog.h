@@ -0,0 +1,169 @@
+//
+// Created by Shikha Pallavi on 10/16/26.
+//
+
+#ifndef P1X_EVENTLOG_H
+#define P1X_EVENTLOG_H
+
+// AUTHOR: Shikha Pallavi
+// PROGRAM: EventLog.h
+// DATE: 10/16/2026
+// PURPOSE: Header file for an append-only binary log of the members, books and ratings added since the
+// last snapshot, so saving costs as much as the changes and not as much as the whole rating map.
+// INPUT: None directly from the user. The session appends every change it makes and replays the log at start.
+// PROCESS: The log starts with a magic tag, followed by one record per change:
+//     length (4 bytes) | checksum (4 bytes) | type (1 byte) | fields
+// Records are gathered in memory and written and synced together (group commit) once LOG_COMMIT_RECORDS
+// are waiting, once the oldest waiting record is LOG_COMMIT_MS old, or when the session asks. A crash
+// loses at most the records of the open group. Member and book records carry the index they were given,
+// so replaying a log whose start is already in the snapshot skips those records instead of adding them
+// twice. Replay stops at the first truncated or damaged record and cuts the file back to the last good one.
+// OUTPUT: None directly. The log hands every replayed change to a callback.
+
+#include<iostream>
+#include<string>
+#include<cstdint>
+#include<cstring>
+#include<chrono>
+#include<unistd.h>
+#include "MappedFile.h"
+
+// Tag at the start of every log file
+#define EVENT_LOG_MAGIC "BOOKLOG2"
+
+// A group is committed once this many records are waiting or the oldest one is this old
+#define LOG_COMMIT_RECORDS 256
+#define LOG_COMMIT_MS 200
+
+// Record types of the log
+#define EVENT_MEMBER 1
+#define EVENT_BOOK 2
+#define EVENT_RATING 3
+
+
+using namespace std;
+
+// Function to compute the checksum stored with every record (the 64-bit FNV-1a hash folded to 32 bits)
+uint32_t logChecksum(const char* data, uint32_t length);
+
+// Struct for one change read back from the log
+struct LogEvent{
+
+    int type;          // EVENT_MEMBER, EVENT_BOOK or EVENT_RATING
+    int index;         // Index of the new member or book, or the member who rated
+    int book;          // Book that was rated
+    int rating;        // Rating that was given
+    int addedBy;       // ID of the user who added the member or introduced the book
+    int year;          // Year of publication of a new book
+    string name;       // Name of a new member, or author of a new book
+    string title;      // Title of a new book
+
+};
+
+// Class for appending changes to a log file and replaying them
+class EventLog{
+private:
+
+    string path;        // Path of the log file
+    int fd;             // Descriptor of the open log file, or -1
+    string pending;     // Records written since the last commit
+    int pendingCount;   // Number of records in pending
+    chrono::steady_clock::time_point pendingSince;  // When the oldest pending record was added
+    long long fileBytes;   // Bytes of the log already on disk
+
+    // Method to cut off whatever part of the pending group reached the file
+    void cutBack();
+
+    // Method to add a record to the pending group and commit the group once it is due
+    void append(const string& record);
+
+    // Method to decode one record, returning false if the bytes do not form a valid record
+    static bool decode(const char* data, uint32_t length, LogEvent& event);
+
+public:
+
+    // Constructor to create a log with no file open
+    EventLog(){
+        fd = -1;
+        pendingCount = 0;
+        fileBytes = 0;
+    }
+
+    // Destructor commits the pending group and closes the file
+    ~EventLog(){
+        close();
+    }
+
+    // Method to open (or create) a log file, returning false (with a reason) if it cannot be used
+    bool open(string filePath, string& error);
+
+    // Method to call visit(event) for every valid record in file order, returning the number of records
+    template<typename Visit>
+    int replay(Visit visit);
+
+    // Method to log a new member
+    void addMember(int index, const string& name, int addedBy);
+
+    // Method to log a new book
+    void addBook(int index, const string& author, const string& title, int year, int introducer);
+
+    // Method to log a rating
+    void addRating(int member, int book, int rating);
+
+    // Method to write and sync the pending group, returning false if the file could not be written (the
+    // group stays pending and the file keeps only the records committed before it)
+    bool commit();
+
+    // Method to empty the log once everything in it is safely in a snapshot
+    bool reset();
+
+    // Method to get the size of the log in bytes, pending records included
+    long long size() const{
+        return fileBytes + (long long)pending.size();
+    }
+
+    // Method to commit the pending group and close the file
+    void close();
+
+};
+
+// Method to call visit(event) for every valid record in file order, returning the number of records
+template<typename Visit>
+int EventLog::replay(Visit visit){
+    MappedFile file;
+    string error;
+    if(!file.open(path, error) || file.size() <= strlen(EVENT_LOG_MAGIC)){
+        return 0;
+    }
+
+    // Walk the records until the end of the file or the first one that is cut short or damaged
+    const char* data = file.data();
+    size_t end = file.size();
+    size_t at = strlen(EVENT_LOG_MAGIC);
+    int count = 0;
+    LogEvent event;
+    while(at + 8 <= end){
+        uint32_t length, checksum;
+        memcpy(&length, data + at, 4);
+        memcpy(&checksum, data + at + 4, 4);
+        if(length > end - at - 8 || checksum != logChecksum(data + at + 8, length) ||
+           !decode(data + at + 8, length, event)){
+            break;
+        }
+        visit(event);
+        count++;
+        at += 8 + length;
+    }
+
+    // Appending after a torn record would hide everything behind it, so cut it off
+    if(at < end){
+        cout<<"Dropping "<<end - at<<" damaged bytes at the end of "<<path<<"\n";
+        if(ftruncate(fd, at) != 0){
+            cout<<"Error truncating "<<path<<".\n";
+        }
+    }
+    fileBytes = at;
+    return count;
+}
+
+#endif //P1X_EVENTLOG_H
@@ -0,0 +1,46 @@
+// AUTHOR: Shikha Pallavi
+// PROGRAM: FileSync.cpp
+// DATE: 10/17/2026
+
+// PURPOSE: This file contains the implementation of the durable file replacement.
+
+// INPUT: replaceFile takes the path of the finished temporary file and the path it replaces.
+
+// PROCESS: The temporary file is opened read-only only to fsync it. The directory is the part of the
+// path before the last '/' (the working directory when there is none), opened with O_DIRECTORY and
+// fsynced after the rename.
+
+// OUTPUT: replaceFile returns whether the new file is on disk and in place.
+
+#include<iostream>
+#include<string>
+#include<cstdio>
+#include<fcntl.h>
+#include<unistd.h>
+#include "FileSync.h"
+
+
+using namespace std;
+
+// Function to fsync the file or directory at a path, returning false if it cannot be opened or synced
+static bool syncPath(const string& path, int flags){
+    int fd = open(path.c_str(), flags);
+    if(fd < 0){
+        return false;
+    }
+    bool synced = fsync(fd) == 0;
+    close(fd);
+    return synced;
+}
+
+// Function to sync a finished temporary file, rename it over filePath and sync the directory holding it,
+// returning false if any step failed (the temporary file is removed if it was not renamed)
+bool replaceFile(const string& tempPath, const string& filePath){
+    if(!syncPath(tempPath, O_RDONLY) || rename(tempPath.c_str(), filePath.c_str()) != 0){
+        remove(tempPath.c_str());
+        return false;
+    }
+    size_t slash = filePath.rfind('/');
+    string directory = slash == string::npos ? "." : (slash == 0 ? "/" : filePath.substr(0, slash));
+    return syncPath(directory, O_RDONLY | O_DIRECTORY);
+}
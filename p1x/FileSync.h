@@ -0,0 +1,29 @@
+//
+// Created by Shikha Pallavi on 10/17/26.
+//
+
+#ifndef P1X_FILESYNC_H
+#define P1X_FILESYNC_H
+
+// AUTHOR: Shikha Pallavi
+// PROGRAM: FileSync.h
+// DATE: 10/17/2026
+// PURPOSE: Header file for replacing a file with a new version that is durably on disk.
+// INPUT: None directly from the user. The savers pass a finished temporary file and the path it replaces.
+// PROCESS: The temporary file is synced, renamed over the old file and then the directory holding it is
+// synced, since a rename is a change to the directory and is not on disk until the directory is. Only
+// after that is the new file guaranteed to be the one found after a crash, so callers that drop other
+// data once the file is written (the change log after a snapshot) must wait for replaceFile to return.
+// OUTPUT: None directly. replaceFile reports whether the new file is on disk and in place.
+
+#include<iostream>
+#include<string>
+
+
+using namespace std;
+
+// Function to sync a finished temporary file, rename it over filePath and sync the directory holding it,
+// returning false if any step failed (the temporary file is removed if it was not renamed)
+bool replaceFile(const string& tempPath, const string& filePath);
+
+#endif //P1X_FILESYNC_H
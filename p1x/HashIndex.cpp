@@ -0,0 +1,97 @@
+
+// AUTHOR: Shikha Pallavi
+// PROGRAM: HashIndex.cpp
+// DATE: 10/17/2026
+
+// PURPOSE: This file contains the implementation of the hash table of rows shared by the lists.
+
+// INPUT: insert takes a row and the hash of its key; erase takes a row.
+
+// PROCESS: A row goes in the first free slot at or after the home slot of its hash (the hash's low bits),
+// and its hash is kept by row for growing the table and taking the row out. erase finds the row on its
+// run and then walks the rest of the run: a row whose home slot is not between the hole and itself is
+// moved into the hole, which moves on to where the row was. The run ends at a free slot, and the last
+// hole is freed.
+
+// OUTPUT: None directly. The lists read the table through forEach.
+
+#include<iostream>
+#include "HashIndex.h"
+
+
+using namespace std;
+
+// Constructor to create an empty table
+HashIndex::HashIndex(){
+    slots.assign(1024, HASH_SLOT_EMPTY);
+    count = 0;
+}
+
+// Method to double the table
+void HashIndex::grow(){
+    vector<int> old;
+    old.swap(slots);
+    slots.assign(old.size() * 2, HASH_SLOT_EMPTY);
+    size_t mask = slots.size() - 1;
+    for(int row : old){
+        if(row == HASH_SLOT_EMPTY) continue;
+        size_t i = rowHashes[row] & mask;
+        while(slots[i] != HASH_SLOT_EMPTY){
+            i = (i + 1) & mask;
+        }
+        slots[i] = row;
+    }
+}
+
+// Method to make room for n rows without growing again
+void HashIndex::reserve(size_t n){
+    rowHashes.reserve(n);
+    while(2 * n > slots.size()){
+        grow();
+    }
+}
+
+// Method to add a row with the hash of its key
+void HashIndex::insert(int row, uint64_t hash){
+    if((size_t)row >= rowHashes.size()){
+        rowHashes.resize(row + 1);
+    }
+    rowHashes[row] = hash;
+    size_t mask = slots.size() - 1;
+    size_t i = hash & mask;
+    while(slots[i] != HASH_SLOT_EMPTY){
+        i = (i + 1) & mask;
+    }
+    slots[i] = row;
+    count++;
+    if(count * 2 > slots.size()){
+        grow();
+    }
+}
+
+// Method to take a row out
+void HashIndex::erase(int row){
+    if((size_t)row >= rowHashes.size()){
+        return;
+    }
+    size_t mask = slots.size() - 1;
+    size_t hole = rowHashes[row] & mask;
+    while(slots[hole] != row){
+        if(slots[hole] == HASH_SLOT_EMPTY){
+            return;
+        }
+        hole = (hole + 1) & mask;
+    }
+
+    // A later row of the run moves back into the hole unless its home slot lies after the hole
+    for(size_t next = (hole + 1) & mask ; slots[next] != HASH_SLOT_EMPTY ; next = (next + 1) & mask){
+        size_t home = rowHashes[slots[next]] & mask;
+        bool stays = hole <= next ? (home > hole && home <= next) : (home > hole || home <= next);
+        if(!stays){
+            slots[hole] = slots[next];
+            hole = next;
+        }
+    }
+    slots[hole] = HASH_SLOT_EMPTY;
+    count--;
+}
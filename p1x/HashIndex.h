@@ -0,0 +1,86 @@
+//
+// Created by Shikha Pallavi on 10/17/26.
+//
+
+#ifndef P1X_HASHINDEX_H
+#define P1X_HASHINDEX_H
+
+// AUTHOR: Shikha Pallavi
+// PROGRAM: HashIndex.h
+// DATE: 10/17/2026
+// PURPOSE: Header file for a hash table from the hash of a key to row numbers, shared by the book list (books
+// by author, title and year) and the member list (members by name).
+// INPUT: None directly from the user. The lists add and remove rows with the hash of their key.
+// PROCESS: The table is an open-addressing table of rows probed linearly, doubled when half full. Rows are
+// small numbers (a list's indices), so the hash of every row is kept in an array indexed by row rather
+// than in the slots, which keeps the table at four bytes a slot. Several rows may share a hash (the same
+// key twice, or two keys that collide), so forEach hands over every row stored with a hash and the list
+// compares the row's fields itself. Taking a row out moves the rest of its run back, so no slot is left
+// as a marker and a lookup still stops at the first free slot. prefetch starts loading the first slot of
+// a hash, so a batch of lookups waits for its cache misses together instead of one after the other.
+// OUTPUT: None directly. The table hands rows to a callback.
+
+#include<iostream>
+#include<vector>
+#include<cstdint>
+
+// Marks a free slot of the table
+#define HASH_SLOT_EMPTY -1
+
+
+using namespace std;
+
+// Class for finding rows by the hash of their key
+class HashIndex{
+private:
+
+    vector<int> slots;          // Open-addressing table of rows, a power of two in size
+    vector<uint64_t> rowHashes; // Hash every row was added with, by row
+    size_t count;               // Number of rows in the table
+
+    // Method to double the table
+    void grow();
+
+public:
+
+    // Constructor to create an empty table
+    HashIndex();
+
+    // Method to make room for n rows without growing again
+    void reserve(size_t n);
+
+    // Method to add a row with the hash of its key
+    void insert(int row, uint64_t hash);
+
+    // Method to take a row out
+    void erase(int row);
+
+    // Method to get the number of rows in the table
+    size_t size() const{
+        return count;
+    }
+
+    // Method to get the hash a row was added with
+    uint64_t hashOf(int row) const{
+        return rowHashes[row];
+    }
+
+    // Method to start loading the first slot a lookup of the hash reads
+    void prefetch(uint64_t hash) const{
+        __builtin_prefetch(&slots[hash & (slots.size() - 1)]);
+    }
+
+    // Method to call visit(row) for every row added with the hash
+    template<typename Visit>
+    void forEach(uint64_t hash, Visit visit) const{
+        size_t mask = slots.size() - 1;
+        for(size_t i = hash & mask ; slots[i] != HASH_SLOT_EMPTY ; i = (i + 1) & mask){
+            if(rowHashes[slots[i]] == hash){
+                visit(slots[i]);
+            }
+        }
+    }
+
+};
+
+#endif //P1X_HASHINDEX_H
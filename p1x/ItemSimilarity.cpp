@@ -0,0 +1,225 @@
+
+// AUTHOR: Shikha Pallavi
+// PROGRAM: ItemSimilarity.cpp
+// DATE: 10/16/2026
+
+// PURPOSE: This file contains the implementation of the item-based (book to book) recommendation model.
+
+// INPUT: build and refresh read the ratings from a RatingList. recommend takes a member id and the number
+// of books wanted. save and load take the path of the model file.
+
+// PROCESS: A row is computed by walking the raters of the book and, for each of them, the other books they
+// rated, adding up the rating products per book; the best ITEM_NEIGHBOURS positive ones are kept. Rows are
+// split over the RatingList's thread pool, each part with its own scratch arrays. recommend first recomputes the rows
+// marked by ratingChanged, then adds up, for every book the user rated, the user's rating times the
+// similarity of each of its neighbours, and keeps the best books the user has not rated.
+
+// OUTPUT: recommend returns scored books, best first. save writes one line per book with its similar books
+// and their similarities, after a header line with the book count, neighbour count and rating checksum.
+
+#include<iostream>
+#include<string>
+#include<fstream>
+#include<sstream>
+#include<algorithm>
+#include "ItemSimilarity.h"
+
+
+using namespace std;
+
+// Method to order book scores by score, then by lower book id
+static bool higherScore(const BookScore& a, const BookScore& b){
+    return a.score > b.score || (a.score == b.score && a.book < b.book);
+}
+
+// Method to recompute the rows of the given books, spreading them over the ratings' thread pool
+void ItemSimilarity::computeRows(RatingList& ratings, const vector<int>& bookList){
+    if(bookList.empty()){
+        return;
+    }
+    ratings.flushPending();
+    int numBooks = ratings.getBookCapacity();
+    ThreadPool* pool = ratings.getPool();
+    int count = (int)bookList.size();
+    int parts = pool ? min(count, 4 * pool->size()) : 1;
+
+    auto computeRange = [&](int part){
+        vector<long long> score(numBooks, 0);
+        vector<int> touched;
+        int first = (int)((long long)count * part / parts);
+        int last = (int)((long long)count * (part + 1) / parts);
+        for(int k = first ; k<last ; k++){
+            int book = bookList[k];
+
+            // Add up the rating products with every book that shares a rater with this one
+            for(const Rater& r : ratings.ratersOf(book)){
+                ratings.forEachRating(r.member, [&](int other, int rating){
+                    if(other == book) return;
+                    if(score[other] == 0){
+                        touched.push_back(other);
+                    }
+                    score[other] += (long long)r.rating * rating;
+                });
+            }
+
+            // Keep the most similar books with a positive similarity
+            vector<BookScore> row;
+            for(int other : touched){
+                if(score[other] > 0){
+                    BookScore bs;
+                    bs.book = other;
+                    bs.score = score[other];
+                    row.push_back(bs);
+                }
+                score[other] = 0;
+            }
+            touched.clear();
+            if((int)row.size() > neighbours){
+                partial_sort(row.begin(), row.begin() + neighbours, row.end(), higherScore);
+                row.resize(neighbours);
+            }
+            else{
+                sort(row.begin(), row.end(), higherScore);
+            }
+            rows[book].swap(row);
+        }
+    };
+    if(parts > 1){
+        pool->run(parts, computeRange);
+    }
+    else{
+        computeRange(0);
+    }
+}
+
+// Method to mark a book's row for recomputation
+void ItemSimilarity::markDirty(int book){
+    if(book >= (int)rows.size()){
+        rows.resize(book + 1);
+        dirty.resize(book + 1, 0);
+    }
+    if(!dirty[book]){
+        dirty[book] = 1;
+        dirtyBooks.push_back(book);
+    }
+}
+
+// Method to build every row of the model for the first numBooks books
+void ItemSimilarity::build(RatingList& ratings, int numBooks){
+    rows.assign(numBooks, vector<BookScore>());
+    dirty.assign(numBooks, 0);
+    dirtyBooks.clear();
+    vector<int> all(numBooks);
+    for(int b = 0 ; b<numBooks ; b++){
+        all[b] = b;
+    }
+    computeRows(ratings, all);
+}
+
+// Method to mark the rows changed by a member's new rating of a book (call after setting the rating)
+void ItemSimilarity::ratingChanged(const RatingList& ratings, int member, int book){
+
+    // Only the pairs (book, other book the member rated) change
+    markDirty(book);
+    ratings.forEachRating(member, [&](int other, int){
+        markDirty(other);
+    });
+}
+
+// Method to recompute every marked row
+void ItemSimilarity::refresh(RatingList& ratings){
+    if(dirtyBooks.empty()){
+        return;
+    }
+    computeRows(ratings, dirtyBooks);
+    for(int b : dirtyBooks){
+        dirty[b] = 0;
+    }
+    dirtyBooks.clear();
+}
+
+// Method to recommend up to n books the user has not rated, scored through the books the user rated
+vector<BookScore> ItemSimilarity::recommend(RatingList& ratings, int user, int n){
+    refresh(ratings);
+    ratings.flushPending();
+
+    // Every book the user rated passes its rating on to its similar books
+    vector<BookScore> picks;
+    vector<long long> score(rows.size(), 0);
+    vector<int> touched;
+    ratings.forEachRating(user, [&](int book, int rating){
+        if(book >= (int)rows.size()) return;
+        for(const BookScore& bs : rows[book]){
+            if(score[bs.book] == 0){
+                touched.push_back(bs.book);
+            }
+            score[bs.book] += rating * bs.score;
+        }
+    });
+
+    for(int book : touched){
+        if(score[book] > 0 && ratings.getRating(user, book) == 0){
+            BookScore bs;
+            bs.book = book;
+            bs.score = score[book];
+            picks.push_back(bs);
+        }
+        score[book] = 0;
+    }
+    int keep = max(0, min(n, (int)picks.size()));
+    partial_sort(picks.begin(), picks.begin() + keep, picks.end(), higherScore);
+    picks.resize(keep);
+    return picks;
+}
+
+// Method to write the model to a text file, tagged with the checksum of the ratings it was built from
+bool ItemSimilarity::save(string filePath, uint64_t ratingChecksum){
+    ofstream outputFile(filePath);
+    if(!outputFile){
+        return false;
+    }
+    outputFile<<rows.size()<<" "<<neighbours<<" "<<ratingChecksum<<"\n";
+    for(size_t b = 0 ; b<rows.size() ; b++){
+        outputFile<<rows[b].size();
+        for(const BookScore& bs : rows[b]){
+            outputFile<<" "<<bs.book<<" "<<bs.score;
+        }
+        outputFile<<"\n";
+    }
+    outputFile.close();
+    return true;
+}
+
+// Method to read a model written by save, if it was built for numBooks books from ratings with the
+// given checksum
+bool ItemSimilarity::load(string filePath, int numBooks, uint64_t ratingChecksum){
+    ifstream inputFile(filePath);
+    if(!inputFile){
+        return false;
+    }
+    int fileBooks, fileNeighbours;
+    uint64_t fileChecksum;
+    if(!(inputFile>>fileBooks>>fileNeighbours>>fileChecksum) || fileBooks != numBooks ||
+       fileNeighbours != neighbours || fileChecksum != ratingChecksum){
+        return false;
+    }
+
+    vector<vector<BookScore>> loaded(numBooks);
+    for(int b = 0 ; b<numBooks ; b++){
+        int count;
+        if(!(inputFile>>count) || count < 0 || count > neighbours){
+            return false;
+        }
+        loaded[b].resize(count);
+        for(int k = 0 ; k<count ; k++){
+            if(!(inputFile>>loaded[b][k].book>>loaded[b][k].score) || loaded[b][k].book < 0 ||
+               loaded[b][k].book >= numBooks){
+                return false;
+            }
+        }
+    }
+    rows.swap(loaded);
+    dirty.assign(numBooks, 0);
+    dirtyBooks.clear();
+    return true;
+}
@@ -0,0 +1,82 @@
+//
+// Created by Shikha Pallavi on 10/16/26.
+//
+
+#ifndef P1X_ITEMSIMILARITY_H
+#define P1X_ITEMSIMILARITY_H
+
+// AUTHOR: Shikha Pallavi
+// PROGRAM: ItemSimilarity.h
+// DATE: 10/16/2026
+// PURPOSE: Header file for an item-based recommendation model: for every book, the books most similar to it.
+// INPUT: None directly from the user. The model is built from a RatingList, or loaded from a file
+// written by an earlier run.
+// PROCESS: The similarity of two books is the sum of the rating products over the members who rated
+// both, the same measure RatingList uses between members. Each book keeps only its ITEM_NEIGHBOURS most
+// similar books. A rating change by member m on book b only changes the rows of b and of the other books
+// m rated, so those rows are marked and recomputed before the next recommendation. Rows are computed on
+// the RatingList's thread pool. A saved model is tagged with the checksum of the ratings it was built
+// from, and is only loaded again for exactly those ratings.
+// OUTPUT: None directly. The model returns scored book recommendations and can be saved to a text file.
+
+#include<iostream>
+#include<string>
+#include<vector>
+#include<cstdint>
+#include "RatingList.h"
+
+// Number of similar books kept for every book
+#define ITEM_NEIGHBOURS 20
+
+
+using namespace std;
+
+// Class for holding the most similar books of every book
+class ItemSimilarity{
+private:
+
+    vector<vector<BookScore>> rows;  // Most similar books of every book, best first
+    vector<char> dirty;              // Flag per book whose row must be recomputed
+    vector<int> dirtyBooks;          // Books whose row must be recomputed
+    int neighbours;                  // Number of similar books kept per book
+
+    // Method to recompute the rows of the given books, spreading them over the ratings' thread pool
+    void computeRows(RatingList& ratings, const vector<int>& bookList);
+
+    // Method to mark a book's row for recomputation
+    void markDirty(int book);
+
+public:
+
+    // Constructor to create an empty model keeping k similar books per book
+    ItemSimilarity(int k){
+        neighbours = k;
+    }
+
+    // Method to get the number of books covered by the model
+    int size() const{
+        return (int)rows.size();
+    }
+
+    // Method to build every row of the model for the first numBooks books
+    void build(RatingList& ratings, int numBooks);
+
+    // Method to mark the rows changed by a member's new rating of a book (call after setting the rating)
+    void ratingChanged(const RatingList& ratings, int member, int book);
+
+    // Method to recompute every marked row
+    void refresh(RatingList& ratings);
+
+    // Method to recommend up to n books the user has not rated, scored through the books the user rated
+    vector<BookScore> recommend(RatingList& ratings, int user, int n);
+
+    // Method to write the model to a text file, tagged with the checksum of the ratings it was built from
+    bool save(string filePath, uint64_t ratingChecksum);
+
+    // Method to read a model written by save, if it was built for numBooks books from ratings with the
+    // given checksum
+    bool load(string filePath, int numBooks, uint64_t ratingChecksum);
+
+};
+
+#endif //P1X_ITEMSIMILARITY_H
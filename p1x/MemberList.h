@@ -12,26 +12,34 @@
 // INPUT:The program does not directly take input from users. It can be extended to accept user input for
 // adding members.
 // PROCESS:The program defines a structure Member to represent individual members and a class MemberList
-// to manage a list of members. MemberList provides methods to add members to the list, resize the
-// array dynamically, and retrieve the member array pointer.
+// to manage a list of members. MemberList provides methods to add members to the list, one at a time or
+// in bulk, and to read and replace a member by index. A Member holds a handle into the string pool
+// instead of a string, so it is copied with memcpy and reading one allocates nothing. The list keeps each
+// field in its own array (a ColumnStore), which grows by moving its elements. Every member is also kept in
+// a hash table (a HashIndex) by name, so the accounts of a name are found in O(1) rather than by a scan.
 // OUTPUT:The program does not directly produce any output. It can be extended to output information about
 // the members stored in the list.
 
 #include<iostream>
 #include<string>
+#include<vector>
+#include "StringPool.h"
+#include "ColumnStore.h"
+#include "HashIndex.h"
+#include "Fnv.h"
 
 using namespace std;
 
-// Structure for representing a member
+// Structure for representing a member (plain data; the name lives in the shared string pool)
 struct Member{
 
-    string Name;  // Name of the member
+    PooledString Name;  // Name of the member
     int Account;  // Account number of the member
     int adddedBY;  // ID of the user who added the member
 
 
     // Constructor to initialize all attributes of the member
-    Member(string nm, int ac, int loggedInUser){
+    Member(PooledString nm, int ac, int loggedInUser){
         Name = nm;
         Account = ac;
         adddedBY = loggedInUser;
@@ -48,37 +56,97 @@ class MemberList{
 private:
 
 
-    Member* memberArray;  // Pointer to an array of members
-    int capacity;   // Capacity of the array
-    int countMem = 0;  // Number of members currently in the array
+    // Fields of every member, one array each: name, account number, added by
+    ColumnStore<PooledString, int, int> members;
+    HashIndex names;  // Members by the hash of their name
 
+    // Method to check whether the member at an index has the given name
+    bool sameName(int i, const char* name, size_t n) const{
+        PooledString own = members.at<0>(i);
+        return own.size() == n && memcmp(own.data(), name, n) == 0;
+    }
 
 
 public:
 
-    // Constructor to initialize the member array with a specified initial capacity
-    MemberList(int initialCapacity){
-        memberArray = new Member[initialCapacity];
-        capacity = initialCapacity;
+    // Constructor to initialize the member list with room for a specified initial number of members
+    MemberList(int initialCapacity) : members(initialCapacity){
+    }
 
+    // Method to get a copy of the member at an index
+    Member getMember(int i) const{
+        return Member(members.at<0>(i), members.at<1>(i), members.at<2>(i));
     }
 
-    // Destructor to deallocate memory for the member array
-    ~MemberList(){
-        delete[] memberArray;
+    // Method to get the name of the member at an index
+    PooledString getName(int i) const{
+        return members.at<0>(i);
     }
 
+    // Method to replace the member at an index
+    void setMember(int i, const Member& m);
 
-    // Method to get the pointer to the member array
-    Member* getMemberArray();
+    // Method to get the number of members in the list
+    int getCount() const{
+        return members.size();
+    }
 
-    // Method to resize the member array when it reaches capacity
-    void resizeArray();
+    // Method to grow the member list to hold at least n members in one step
+    void reserve(int n){
+        members.reserve(n);
+        names.reserve(n);
+    }
 
     // Method to add a new member to the list
-    void addMember(string name, int loggedInUser);
+    void addMember(PooledString name, int loggedInUser);
+
+    // Method to add n members at once, member i given by make(i); account numbers follow on from the list
+    template<typename Make>
+    void addMembers(int n, Make make){
+        vector<uint64_t> hashes(n);
+        addMembers(n, [&](int i){
+            Member m = make(i);
+            hashes[i] = hashBytes(m.Name.data(), m.Name.size());
+            return m;
+        }, [&](int i){
+            return hashes[i];
+        });
+    }
+
+    // Method to add n members at once whose name hashes are known already (member i given by make(i), the
+    // hash of its name by nameHash(i), called after every member was made), such as members read from a
+    // snapshot
+    template<typename Make, typename NameHash>
+    void addMembers(int n, Make make, NameHash nameHash){
+        int first = members.size();
+        members.appendRows(n, [&](int i){
+            Member m = make(i);
+            return make_tuple(m.Name, first + i + 1, m.adddedBY);
+        });
+
+        // The members go in the name table in a loop of their own, so its cache misses overlap
+        names.reserve(first + n);
+        for(int i = 0 ; i<n ; i++){
+            names.insert(first + i, nameHash(i));
+        }
+    }
+
+    // Method to get the hash of the name of the member at an index
+    uint64_t nameHash(int i) const{
+        return names.hashOf(i);
+    }
+
+    // Method to find the first member with a name, returning its index (account number - 1) or -1
+    int findMember(const char* name, size_t n) const;
+
+    // Method to put the index of every member with a name in accounts, in account order
+    void findMembers(const char* name, size_t n, vector<int>& accounts) const;
+
+    // Method to find many names at once, accounts[i] receiving the index of the first member called
+    // wanted[i] or -1
+    void findMembers(const vector<string>& wanted, vector<int>& accounts) const;
 
 
 };
 
-#endif //P1X_MEMBERLIST_H
+#endif //P1X_MEMBERLIST_H
\ No newline at end of file
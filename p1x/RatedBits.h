@@ -0,0 +1,125 @@
+//
+// Created by Shikha Pallavi on 10/16/26.
+//
+
+#ifndef P1X_RATEDBITS_H
+#define P1X_RATEDBITS_H
+
+// AUTHOR: Shikha Pallavi
+// PROGRAM: RatedBits.h
+// DATE: 10/16/2026
+// PURPOSE: Header file for a bitset per member recording which books the member has rated.
+// INPUT: None directly from the user. RatingList reports every rating change through set().
+// PROCESS: Each member's row holds one bit per book, 64 books to a word. Comparing two rows a word at a
+// time answers "which books did both rate" (AND) and "which books did the neighbour rate but not the
+// user" (neighbour AND NOT user) for 64 books per instruction, and a popcount of the AND gives the number
+// of co-rated books without reading a single rating. The words are kept in blocks of RATED_BLOCK_MEMBERS
+// rows x RATED_BLOCK_WORDS words, laid out like the tiles of the rating map: a block is allocated on the
+// first book rated in it, a missing block reads as zeros, and adding members or books only extends the
+// grid of blocks, so no row is ever copied.
+// OUTPUT: None directly. The bitsets answer overlap counts and candidate book lists.
+
+#include<iostream>
+#include<string>
+#include<vector>
+#include<cstdint>
+
+// Number of books covered by one word of a member's bitset
+#define BITS_PER_WORD 64
+
+// Members and words in one block of the bitsets (one tile of the rating map, 64 members x 256 books)
+#define RATED_BLOCK_MEMBERS 64
+#define RATED_BLOCK_WORDS 4
+
+
+using namespace std;
+
+// Class for keeping, per member, the set of books the member rated
+class RatedBits{
+private:
+
+    vector<vector<uint64_t*>> blocks;  // Block grid [member block][word block]; null blocks hold only zeros
+    int members;                       // Number of members covered
+    int words;                         // Number of words in every row
+
+    // Method to get the number of blocks needed to cover n rows or words
+    static int blocksFor(int n, int blockSize){
+        return (n + blockSize - 1) / blockSize;
+    }
+
+public:
+
+    // Constructor to create empty bitsets for m members and b books
+    RatedBits(int m, int b){
+        members = 0;
+        words = 0;
+        growMembers(m);
+        growBooks(b);
+    }
+
+    // Destructor to free every block
+    ~RatedBits();
+
+    RatedBits(const RatedBits&) = delete;
+    RatedBits& operator=(const RatedBits&) = delete;
+
+    // Method to add empty rows until the bitsets cover m members
+    void growMembers(int m);
+
+    // Method to widen every row until it covers b books
+    void growBooks(int b);
+
+    // Method to record whether a member has rated a book
+    void set(int member, int book, bool rated);
+
+    // Method to get the words [wordBlock * RATED_BLOCK_WORDS, + RATED_BLOCK_WORDS) of a member's row, or null
+    // when the member rated none of their books
+    const uint64_t* blockRow(int member, int wordBlock) const{
+        const uint64_t* block = blocks[member / RATED_BLOCK_MEMBERS][wordBlock];
+        return block ? block + (member % RATED_BLOCK_MEMBERS) * RATED_BLOCK_WORDS : nullptr;
+    }
+
+    // Method to check whether two block rows (either may be null) share a rated book
+    static bool shareBook(const uint64_t* rowA, const uint64_t* rowB){
+        if(rowA == nullptr || rowB == nullptr){
+            return false;
+        }
+        uint64_t any = 0;
+        for(int w = 0 ; w<RATED_BLOCK_WORDS ; w++){
+            any |= rowA[w] & rowB[w];
+        }
+        return any != 0;
+    }
+
+    // Method to check whether two members rated any common book in a block of words
+    bool overlaps(int a, int b, int wordBlock) const{
+        return shareBook(blockRow(a, wordBlock), blockRow(b, wordBlock));
+    }
+
+    // Method to check whether a member rated any book in a block of words
+    bool ratedAny(int member, int wordBlock) const{
+        const uint64_t* row = blockRow(member, wordBlock);
+        if(row == nullptr){
+            return false;
+        }
+        uint64_t any = 0;
+        for(int w = 0 ; w<RATED_BLOCK_WORDS ; w++){
+            any |= row[w];
+        }
+        return any != 0;
+    }
+
+    // Method to get the number of words in every row
+    int getWords() const{
+        return words;
+    }
+
+    // Method to count the books both members rated
+    int coRated(int a, int b) const;
+
+    // Method to list, in increasing order, the books the neighbour rated and the user did not
+    void unratedBy(int user, int neighbour, vector<int>& found) const;
+
+};
+
+#endif //P1X_RATEDBITS_H
@@ -11,169 +11,883 @@
 
 // INPUT: The resizeMembers and resizeBooks methods do not directly take input from users.
 // They resize the rating map based on the number of members and books, respectively.
-// The recomendBook method takes the ID of the user for whom book recommendations are needed.
+// The recomendBook method takes the ID of the user for whom book recommendations are needed and the scratch
+// arena that holds the result.
 
-// PROCESS: The resizeMembers method doubles the capacity of the rating map for members and initializes
-// new rows for additional members. The resizeBooks method doubles the capacity of the rating map for
-// books and initializes new columns for additional books. The recomendBook method finds the most similar
+// PROCESS: The resizeMembers method doubles the capacity of the rating map for members and adds rows of
+// tiles for additional members. The resizeBooks method doubles the capacity of the rating map for
+// books and adds columns of tiles for additional books; neither copies existing ratings. Both go
+// through reserve, which loaders also call once with the final size so nothing grows during a load. The recomendBook method finds the most similar
 // user based on ratings and recommends books not rated by the given user but rated by the most similar user.
+// When the dense map would grow too large the ratings are moved into the sparse store. The most similar
+// user is found either by scanning every row with the SIMD dot-product kernel or, when it is cheaper, by
+// walking the rater lists of the books the user rated, which only touches members who share a book.
+// Large scans are split by member range over a thread pool, and the partial results are combined so
+// that ties still go to the lowest member id, exactly as in a single-threaded scan. The neighbour's books
+// are ranked with a counting pass over the rating values (a bucket per value), so ranking is linear in
+// the number of books and stops early when only the top few are wanted. recommendTopBooks keeps the k
+// most similar members in a bounded heap, adds up their ratings weighted by similarity for the books
+// they rated, and keeps the n best books the user has not rated in a second bounded heap. When the
+// similarity cache is on, every rating change adds (new - old) * rating to the pairs it forms with the
+// book's other raters, and the most similar member is read from the cache. recommendForAll computes the
+// similarities of all member pairs at once as the product of the rating matrix with its transpose,
+// one pair of tiles at a time and each pair once (the product is symmetric), with the rows of tiles
+// spread over the thread pool; in the sparse store it runs the exact index search for ranges of members
+// on the pool instead. In the dense map the
+// rated-book bitsets let every scan skip the rows (and tiles) that share no book with the user, and give
+// the neighbour's unrated candidates a word at a time. With the approximate
+// search on, only the members sharing a hash bucket with the user are compared; if none of them has a
+// positive similarity the exact search is used instead, so a user always gets the same kind of answer.
+// The cache and the approximate search are never on together: turning one on turns the other off.
+// addRows takes whole rows for bulk loads: the ratings of new members are appended to the rater lists
+// and written straight into the tiles or the sparse store's arrays, without setRating's per-cell work.
 
 // OUTPUT: The resizeMembers and resizeBooks methods manipulate the rating map to accommodate changes in the number
-// of members and books, respectively. The recomendBook method returns a pair containing information about the similar
-// user and an array of recommended books not rated by the given user. These methods do not directly
+// of members and books, respectively. The recomendBook method returns the similar user and the recommended
+// books not rated by the given user, in an array from the caller's scratch arena; recommendTopBooks returns the scored
+// books best first. These methods do not directly
 // produce any visible output but facilitate the recommendation process based on user ratings.
 
 #include<iostream>
 #include<string>
 #include<algorithm>
 #include "RatingList.h"
+#include "SimilarityKernel.h"
+#include "ThreadPool.h"
+#include "Fnv.h"
 
 
 using namespace std;
 
-// Method to resize the rating map when the number of members changes
-void RatingList::resizeMembers(){
+const int8_t RatingList::zeroSegment[TILE_BOOKS] = {};
 
-    // Allocate a new array with double the capacity for members
-    int** extendedMembers = new int*[2*members];
+// Method to extend the tile grid to the current number of members and books
+void RatingList::growTiles(){
+    int memberTiles = tilesFor(members, TILE_MEMBERS);
+    int bookTiles = tilesFor(books, TILE_BOOKS);
 
-    // Update the number of members
-    members = 2*members;
+    // New tiles start out null and are only allocated when a rating is written into them
+    tileMap.resize(memberTiles);
+    for(int i = 0 ; i<memberTiles ; i++){
+        tileMap[i].resize(bookTiles, nullptr);
+    }
+}
 
-    // Copy existing members to the extended array and initialize new rows
-    for(int i = 0 ; i<members ; i++){
-        if(i<members/2){
-            extendedMembers[i] = ratingMap[i];
+// Method to free every tile of the grid
+void RatingList::freeTiles(){
+    for(size_t i = 0 ; i<tileMap.size() ; i++){
+        for(size_t j = 0 ; j<tileMap[i].size() ; j++){
+            free(tileMap[i][j]);
         }
-        else{
-            extendedMembers[i] = new int[books];
-            for(int j = 0 ; j<books ; j++){
-                ratingMap[i][j] = 0;
+    }
+    tileMap.clear();
+}
+
+// Method to move all ratings from the dense map into the sparse store
+void RatingList::convertToSparse(){
+    sparse = new SparseRatings(members);
+
+    // The grid still has its size from before the resize that triggered the switch
+    int memberRows = min(members, (int)tileMap.size() * TILE_MEMBERS);
+    int bookTiles = tileMap.empty() ? 0 : (int)tileMap[0].size();
+    for(int i = 0 ; i<memberRows ; i++){
+        for(int t = 0 ; t<bookTiles ; t++){
+            const int8_t* segment = rowSegment(i, t);
+            for(int j = 0 ; j<TILE_BOOKS && t*TILE_BOOKS + j < books ; j++){
+                if(segment[j] != 0){
+                    sparse->set(i, t*TILE_BOOKS + j, segment[j]);
+                }
+            }
+        }
+    }
+    sparse->merge();
+    freeTiles();
+    delete ratedBits;
+    ratedBits = nullptr;
+}
+
+// Method to grow the rating map to at least m members and b books in one step
+void RatingList::reserve(int m, int b){
+    if(m <= members && b <= books){
+        return;
+    }
+
+    // Update the number of members and books
+    members = max(members, m);
+    books = max(books, b);
+    dirtyRows.resize((members + BITS_PER_WORD - 1) / BITS_PER_WORD, 0);
+    raterIndex->growBooks(books);
+    if(simCache){
+        simCache->growMembers(members);
+    }
+    if(hashIndex){
+        hashIndex->growMembers(members);
+    }
+
+    // The sparse store only needs empty rows for the new members and has no row width
+    if(!sparse && (long long)members * books > SPARSE_SWITCH_BYTES){
+        convertToSparse();
+    }
+    if(sparse){
+        sparse->growMembers(members);
+        return;
+    }
+
+    // New members and books only add rows and columns of tiles; existing tiles stay where they are
+    growTiles();
+    ratedBits->growMembers(members);
+    ratedBits->growBooks(books);
+}
+
+// Method to add whole rows of ratings at once: member firstMember + i rated bookIds[k] with values[k]
+// for k in [rowStart[i], rowStart[i + 1]), all non-zero; cells outside the map are ignored, and a
+// later cell of a row replaces an earlier one for the same book
+void RatingList::addRows(int firstMember, int count, const uint64_t* rowStart, const int32_t* bookIds,
+                         const int8_t* values){
+
+    // The cache and the hash index follow every change one at a time
+    if(simCache || hashIndex || firstMember < 0 || firstMember + count > members){
+        for(int i = 0 ; i<count ; i++){
+            for(uint64_t k = rowStart[i] ; k<rowStart[i + 1] ; k++){
+                setRating(firstMember + i, bookIds[k], values[k]);
             }
         }
+        return;
     }
 
-    // Deallocate memory for the old array and update the pointer
-    for(int i = 0 ; i<members/2 ; i++){
-        delete[] ratingMap[i];
+    // A row of members numbered after every rater is appended to the rater lists, and dense rows are
+    // written straight into their tiles
+    for(int i = 0 ; i<count ; i++){
+        int member = firstMember + i;
+        if(rowStart[i + 1] > rowStart[i]){
+            dirtyRows[member / BITS_PER_WORD] |= 1ULL << (member % BITS_PER_WORD);
+        }
+        for(uint64_t k = rowStart[i] ; k<rowStart[i + 1] ; k++){
+            int book = bookIds[k];
+            if(book < 0 || book >= books || values[k] == 0) continue;
+            raterIndex->add(member, book, values[k]);
+            if(sparse) continue;
+            ratedBits->set(member, book, true);
+            int8_t*& tile = tileMap[member / TILE_MEMBERS][book / TILE_BOOKS];
+            if(tile == nullptr){
+                tile = (int8_t*)calloc(TILE_MEMBERS * TILE_BOOKS, 1);
+            }
+            tile[(member % TILE_MEMBERS) * TILE_BOOKS + book % TILE_BOOKS] = values[k];
+        }
+    }
+
+    // Sorted rows go straight into the sparse store's arrays when the members have no ratings there yet
+    if(sparse && !sparse->appendRows(firstMember, count, rowStart, bookIds, values, books)){
+        for(int i = 0 ; i<count ; i++){
+            for(uint64_t k = rowStart[i] ; k<rowStart[i + 1] ; k++){
+                if(bookIds[k] >= 0 && bookIds[k] < books){
+                    sparse->set(firstMember + i, bookIds[k], values[k]);
+                }
+            }
+        }
     }
-    delete[] ratingMap;
-    ratingMap = extendedMembers;
 }
 
-// Method to get the rating map
-int** RatingList::getRatingMap(){
-    return ratingMap;
+// Method to resize the rating map when the number of members changes
+void RatingList::resizeMembers(){
+    reserve(2*members, books);
 }
 
 // Method to resize the rating map when the number of books changes
 void RatingList::resizeBooks(){
+    reserve(members, 2*books);
+}
 
-    // Allocate a new array with double the capacity for books
-    int** extendedBooks = new int*[members];
 
-    //Update the number of books
-    books = 2*books;
 
-    // Copy existing books to the extended array and initialize new columns
-    for(int i = 0 ; i<members ; i++){
-        extendedBooks[i] = new int[books];
-        for(int j = 0 ; j<books; j++){
-            if(j<books/2){
-                extendedBooks[i][j] = ratingMap[i][j];
+// Method to scan the member tile rows [firstTile, lastTile) for the member most similar to the user
+void RatingList::scanTileRows(int user, int firstTile, int lastTile, int& maxSimilarity, int& similarUser) const{
+    DotKernel dot = dotKernel();
+    int bookTiles = tilesFor(books, TILE_BOOKS);
+    maxSimilarity = -1;
+    similarUser = -1;
+
+    // Walk one row of tiles at a time so every tile is read front to back
+    for(int mt = firstTile ; mt<lastTile ; mt++){
+        int similarity[TILE_MEMBERS] = {0};
+        for(int bt = 0 ; bt<bookTiles ; bt++){
+            const int8_t* tile = tileMap[mt][bt];
+            if(tile == nullptr || !ratedBits->ratedAny(user, bt)) continue;
+            const int8_t* userRow = rowSegment(user, bt);
+            const uint64_t* userBits = ratedBits->blockRow(user, bt);
+            int width = min(TILE_BOOKS, books - bt*TILE_BOOKS);
+            for(int r = 0 ; r<TILE_MEMBERS ; r++){
+
+                // Rows sharing no book with the user in this tile add nothing
+                int i = mt*TILE_MEMBERS + r;
+                if(i >= members || !RatedBits::shareBook(userBits, ratedBits->blockRow(i, bt))) continue;
+                similarity[r] += dot(userRow, tile + r*TILE_BOOKS, width);
             }
-            else{
-                extendedBooks[i][j] = 0;
+        }
+
+        for(int r = 0 ; r<TILE_MEMBERS ; r++){
+            int i = mt*TILE_MEMBERS + r;
+            if(i >= members) break;
+            if(i == user) continue;
+            if(similarity[r] > maxSimilarity || similarUser == -1){
+                maxSimilarity = similarity[r];
+                similarUser = i;
             }
+        }
+    }
+}
 
+// Method to find the most similar member by comparing the user's row with every row
+int RatingList::scanSimilarUser(int user){
+    int memberTiles = (int)tileMap.size();
+    int maxSimilarity, similarUser;
+
+    // Small maps are not worth waking the pool for
+    if((long long)members * books < PARALLEL_MIN_CELLS || threadCount == 1){
+        scanTileRows(user, 0, memberTiles, maxSimilarity, similarUser);
+        return similarUser;
+    }
+    getPool();
+
+    // Split the tile rows into contiguous ranges, a few per thread so uneven ranges even out. The results
+    // of the parts live on this call's stack and the job holds only a reference to them, so a scan
+    // allocates nothing and scans running at the same time share no state.
+    struct ScanParts{
+        int user, tiles, parts;
+        int similarity[SCAN_MAX_PARTS];
+        int similarUser[SCAN_MAX_PARTS];
+    } scan;
+    scan.user = user;
+    scan.tiles = memberTiles;
+    scan.parts = min(min(memberTiles, 4 * pool->size()), SCAN_MAX_PARTS);
+    pool->run(scan.parts, [this, &scan](int part){
+        int first = (int)((long long)scan.tiles * part / scan.parts);
+        int last = (int)((long long)scan.tiles * (part + 1) / scan.parts);
+        scanTileRows(scan.user, first, last, scan.similarity[part], scan.similarUser[part]);
+    });
+
+    // Ranges are in member order, so keeping the first strictly larger value keeps the lowest id on ties
+    similarUser = -1;
+    for(int part = 0 ; part<scan.parts ; part++){
+        if(scan.similarUser[part] == -1) continue;
+        if(similarUser == -1 || scan.similarity[part] > maxSimilarity){
+            maxSimilarity = scan.similarity[part];
+            similarUser = scan.similarUser[part];
         }
     }
+    return similarUser;
+}
 
-    // Deallocate memory for the old array and update the pointer
-    for(int i = 0 ; i<members ; i++){
-        delete[] ratingMap[i];
+// Method to add up, in the scratch space, the similarity of the user with every member reached through the
+// rater index
+void RatingList::accumulateSimilarities(int user, IndexScratch& scratch) const{
+    vector<int>& simAcc = scratch.similarity;
+    vector<char>& seen = scratch.seen;
+    vector<int>& reached = scratch.reached;
+    if((int)simAcc.size() < members){
+        simAcc.resize(members, 0);
+        seen.resize(members, 0);
+    }
+
+    // Accumulate similarities over the members who rated the same books as the user
+    if(sparse){
+        const int* rated = sparse->rowBooks(user);
+        const int8_t* userRatings = sparse->rowValues(user);
+        for(int k = 0 ; k<sparse->rowLength(user) ; k++){
+            for(const Rater& r : raterIndex->ratersOf(rated[k])){
+                if(!seen[r.member]){
+                    seen[r.member] = 1;
+                    reached.push_back(r.member);
+                }
+                simAcc[r.member] += userRatings[k] * r.rating;
+            }
+        }
+    }
+    else{
+        for(int j = 0 ; j<books ; j++){
+            int userRating = getRating(user, j);
+            if(userRating == 0) continue;
+            for(const Rater& r : raterIndex->ratersOf(j)){
+                if(!seen[r.member]){
+                    seen[r.member] = 1;
+                    reached.push_back(r.member);
+                }
+                simAcc[r.member] += userRating * r.rating;
+            }
+        }
     }
-    delete[] ratingMap;
-    ratingMap = extendedBooks;
+}
 
+// Method to reset the scratch space after accumulateSimilarities
+void RatingList::clearSimilarities(IndexScratch& scratch){
+    for(int m : scratch.reached){
+        scratch.similarity[m] = 0;
+        scratch.seen[m] = 0;
+    }
+    scratch.reached.clear();
 }
 
+// Method to find the most similar member through the rater index
+int RatingList::indexSimilarUser(int user, IndexScratch& scratch) const{
+    accumulateSimilarities(user, scratch);
+    const vector<int>& simAcc = scratch.similarity;
+
+    // Best reached member, lowest id first on ties, as the full scan would pick it
+    int best = -1;
+    for(int m : scratch.reached){
+        if(m == user) continue;
+        if(best == -1 || simAcc[m] > simAcc[best] || (simAcc[m] == simAcc[best] && m < best)){
+            best = m;
+        }
+    }
 
+    // Every member not reached has similarity 0; find the lowest such member (or reached one with 0)
+    int zeroUser = 0;
+    while(zeroUser < members && (zeroUser == user || simAcc[zeroUser] != 0)){
+        zeroUser++;
+    }
 
-void swap(int** arr, int i, int j) {
-    int* temp = arr[i];
-    arr[i] = arr[j];
-    arr[j] = temp;
+    int similarUser;
+    if(best != -1 && simAcc[best] > 0){
+        similarUser = best;
+    }
+    else if(zeroUser < members){
+        similarUser = zeroUser;
+    }
+    else{
+        similarUser = best;
+    }
+
+    // Leave the scratch arrays zeroed for the next request
+    clearSimilarities(scratch);
+    return similarUser;
 }
 
+// Method to turn the member similarity cache on (built from the current ratings) or off; turning it
+// on turns the approximate search off
+void RatingList::setSimilarityCache(bool on){
+    delete simCache;
+    simCache = nullptr;
+    if(!on){
+        return;
+    }
+    delete hashIndex;
+    hashIndex = nullptr;
+    if(sparse){
+        sparse->merge();
+    }
 
-void bubbleSort(int** arr, int size) {
-    for (int i = 0; i < size - 1; i++) {
-        for (int j = 0; j < size - i - 1; j++) {
-            if (arr[j][0] > arr[j + 1][0]) {
-                swap(arr, j, j + 1);
-            }
+    // Every member starts from its exact similarities with the members it shares a book with
+    simCache = new SimilarityCache(members);
+    for(int m = 0 ; m<members ; m++){
+        accumulateSimilarities(m, indexScratch);
+        simCache->refresh(m, indexScratch.reached, indexScratch.similarity);
+        clearSimilarities(indexScratch);
+    }
+}
+
+// Method to update the cached similarities of a member with the other raters of a book before a rating change
+void RatingList::updateSimilarities(int member, int book, int rating){
+
+    // A re-rate replaces the old contribution, so only the difference is added
+    int delta = rating - getRating(member, book);
+    if(delta == 0){
+        return;
+    }
+    for(const Rater& r : raterIndex->ratersOf(book)){
+        if(r.member != member){
+            simCache->add(member, r.member, delta * r.rating);
         }
     }
 }
 
+// Method to get the similarity of two members from their rows
+int RatingList::pairSimilarity(int a, int b) const{
+    if(sparse){
+        return sparse->dot(a, b);
+    }
+    DotKernel dot = dotKernel();
+    int similarity = 0;
+    for(int bt = 0 ; bt<tilesFor(books, TILE_BOOKS) ; bt++){
+        if(!ratedBits->overlaps(a, b, bt)) continue;
+        similarity += dot(rowSegment(a, bt), rowSegment(b, bt), min(TILE_BOOKS, books - bt*TILE_BOOKS));
+    }
+    return similarity;
+}
 
+// Method to count the books both members rated
+int RatingList::coRatedCount(int a, int b) const{
+    if(!sparse){
+        return ratedBits->coRated(a, b);
+    }
 
-// Method to recommend books based on user ratings
-int** RatingList::recomendBook(int user){
+    // Sparse rows are sorted by book, so the common books are found by merging the two rows
+    const int* booksA = sparse->rowBooks(a);
+    const int* booksB = sparse->rowBooks(b);
+    int i = 0, j = 0, count = 0;
+    while(i < sparse->rowLength(a) && j < sparse->rowLength(b)){
+        if(booksA[i] == booksB[j]){
+            count++;
+            i++;
+            j++;
+        }
+        else if(booksA[i] < booksB[j]){
+            i++;
+        }
+        else{
+            j++;
+        }
+    }
+    return count;
+}
 
-    // Find the most similar user based on ratings
-    int maxSimilarity = -1;
-    int similarUser;
-    for(int i = 0 ; i<members ; i++){
-        if(i == user) continue;
-        int currSimilarity = 0;
-        for(int j = 0 ; j<books ; j++){
-            if(ratingMap[user][j] != 0 && ratingMap[i][j] != 0){
+// Method to get a checksum of every (member, book, rating), the same whatever order they were added in
+uint64_t RatingList::checksum() const{
 
-                currSimilarity += ratingMap[user][j]*ratingMap[i][j];
-            }
+    // The hashes of the ratings are added up, so the order of the raters of a book does not matter
+    uint64_t total = 0;
+    for(int b = 0 ; b<books ; b++){
+        for(const Rater& r : raterIndex->ratersOf(b)){
+            int32_t fields[3] = {r.member, b, r.rating};
+            total += hashBytes((const char*)fields, sizeof(fields));
         }
-        if(currSimilarity > maxSimilarity){
-            maxSimilarity = currSimilarity;
-            similarUser = i;
+    }
+    return total;
+}
+
+// Method to turn the approximate search on with the given hash tables and bits (0 tables turns it off);
+// the cache and the approximate search are exclusive, so turning the search on turns the cache off
+void RatingList::setApproximateSearch(int tables, int bits){
+    delete hashIndex;
+    hashIndex = nullptr;
+    if(tables <= 0){
+        return;
+    }
+    delete simCache;
+    simCache = nullptr;
+    flushPending();
+
+    // Hash every rating already stored
+    hashIndex = new SimHashIndex(members, tables, bits);
+    for(int m = 0 ; m<members ; m++){
+        forEachRating(m, [&](int book, int rating){
+            hashIndex->update(m, book, 0, rating);
+        });
+    }
+}
+
+// Method to find a similar member among the hash index candidates, falling back to the exact search
+int RatingList::approxSimilarUser(int user){
+    flushPending();
+    hashIndex->candidates(user, hashCandidates);
+
+    // Exact rerank of the candidates, lowest id first on ties
+    int best = -1, bestSimilarity = 0;
+    for(int m : hashCandidates){
+        int similarity = pairSimilarity(user, m);
+        if(similarity > bestSimilarity || (similarity == bestSimilarity && best != -1 && m < best)){
+            best = m;
+            bestSimilarity = similarity;
         }
     }
+    if(best == -1){
+        return exactSimilarUser(user);
+    }
+    return best;
+}
 
-    // Sort the books based on ratings of the most similar user
-    int** arr = new int*[books];
+// Method to measure how often the approximate search finds a member as similar as the exact one,
+// over samples members spread across the first count members who rated something
+double RatingList::recallAtOne(int count, int samples){
+    if(hashIndex == nullptr){
+        return 1.0;
+    }
+    flushPending();
+    vector<int> raters;
+    for(int m = 0 ; m<count && m<members ; m++){
+        bool rated = false;
+        forEachRating(m, [&](int, int){
+            rated = true;
+        });
+        if(rated){
+            raters.push_back(m);
+        }
+    }
+    if(raters.empty() || samples <= 0 || members < 2){
+        return 1.0;
+    }
+
+    // A hit is an approximate neighbour exactly as similar as the exact one (ties count as hits)
+    samples = min(samples, (int)raters.size());
+    int hits = 0;
+    for(int i = 0 ; i<samples ; i++){
+        int user = raters[(long long)raters.size() * i / samples];
+        if(pairSimilarity(user, approxSimilarUser(user)) == pairSimilarity(user, exactSimilarUser(user))){
+            hits++;
+        }
+    }
+    return (double)hits / samples;
+}
+
+// Method to find the most similar member with the cache, the hash index or the exact search
+int RatingList::findSimilarUser(int user){
+
+    // With the cache on, the best neighbour is a lookup unless the user's list has to be refreshed first
+    if(simCache){
+        int best = simCache->bestNeighbour(user);
+        if(best != -1){
+            return best;
+        }
+        if(sparse){
+            sparse->merge();
+        }
+        accumulateSimilarities(user, indexScratch);
+        simCache->refresh(user, indexScratch.reached, indexScratch.similarity);
+        clearSimilarities(indexScratch);
+        best = simCache->bestNeighbour(user);
 
+        // A user with no positive neighbour gets the exact search's pick among the members at 0
+        return best != -1 ? best : exactSimilarUser(user);
+    }
+    if(hashIndex){
+        return approxSimilarUser(user);
+    }
+    return exactSimilarUser(user);
+}
+
+// Method to find the most similar member exactly, choosing the cheaper of the two searches
+int RatingList::exactSimilarUser(int user){
+
+    // The sorted rows make the index search cheaper than any scan of the sparse store
+    if(sparse){
+        sparse->merge();
+        return indexSimilarUser(user, indexScratch);
+    }
+
+    // Estimate the index work as the number of raters of the user's books
+    long long indexWork = 0;
     for(int j = 0 ; j<books ; j++){
-        arr[j] = new int[2];
-        arr[j][0] = ratingMap[similarUser][j];
-        arr[j][1] = j;
+        if(getRating(user, j) != 0){
+            indexWork += raterIndex->ratersOf(j).size();
+        }
+    }
+    if(indexWork * INDEX_VISIT_COST < (long long)members * books){
+        return indexSimilarUser(user, indexScratch);
     }
+    return scanSimilarUser(user);
+}
 
+// Method to rank up to limit books the user has not rated but the neighbour has, best rated first
+// (candidates is scratch space for the call, so calls running at the same time each need their own)
+int RatingList::rankUnratedBooks(int user, int neighbour, int* ranked, int limit, vector<int>& candidates){
+
+    // In the sparse store only the neighbour's own row needs to be visited; in the dense map the
+    // bitsets give the books the neighbour rated and the user did not (neighbour & ~user) directly
+    int count;
+    const int* candidateList;
+    if(sparse){
+        sparse->merge();
+        count = sparse->rowLength(neighbour);
+        candidateList = sparse->rowBooks(neighbour);
+    }
+    else{
+        ratedBits->unratedBy(user, neighbour, candidates);
+        count = (int)candidates.size();
+        candidateList = candidates.data();
+    }
 
-    bubbleSort(arr, books);
+    // Count the candidate books for every rating value
+    int bucketSize[RATING_LEVELS] = {0};
+    for(int k = 0 ; k<count ; k++){
+        int book = candidateList[k];
+        if(!sparse || getRating(user, book) == 0){
+            bucketSize[getRating(neighbour, book) + RATING_LEVELS/2]++;
+        }
+    }
 
-    // Find books not rated by the given user but rated by the most similar user
-    int* bestBooks = new int[books];
-    int count = 0;
+    // Lay the buckets out from the highest rating down, keeping only as many books as the limit allows
+    int bucketStart[RATING_LEVELS];
+    int total = 0;
+    for(int v = RATING_LEVELS-1 ; v>=0 ; v--){
+        bucketStart[v] = total;
+        bucketSize[v] = min(bucketSize[v], limit - total);
+        total += bucketSize[v];
+    }
 
-    for(int i = books-1; i>=0 ; i--){
-        int rating1 = ratingMap[user][arr[i][1]];
-        int rating2 = ratingMap[similarUser][arr[i][1]];
-        if( rating1 == 0 && rating2 != 0){
-            bestBooks[count] = arr[i][1];
-            count++;
+    // Fill the buckets from the highest book id down, stopping once every slot is taken
+    int filled = 0;
+    for(int k = count-1 ; k>=0 && filled<total ; k--){
+        int book = candidateList[k];
+        if(sparse && getRating(user, book) != 0) continue;
+        int v = getRating(neighbour, book) + RATING_LEVELS/2;
+        if(bucketSize[v] > 0){
+            ranked[bucketStart[v]++] = book;
+            bucketSize[v]--;
+            filled++;
         }
     }
+    return total;
+}
+
+// Method to recommend books based on user ratings, with the books taken from the arena
+Recommendation RatingList::recomendBook(int user, ScratchArena& arena){
+    return recomendBook(user, books, arena);
+}
+
+// Method to recommend at most limit books based on user ratings, with the books taken from the arena
+Recommendation RatingList::recomendBook(int user, int limit, ScratchArena& arena){
+    Recommendation ans;
 
+    // Find the most similar user based on ratings
+    ans.similarUser = findSimilarUser(user);
 
-    // Create and return a pair containing information about the similar user and recommended books
-    int** ans;
-    ans = new int*[2];
-    int* detail = new int[2];
-    detail[0] = similarUser;
-    detail[1] = count;
-    ans[0] = detail;
-    ans[1] = bestBooks;
+    // Find books not rated by the given user but rated by the most similar user, best rated first
+    int* bestBooks = arena.allocate<int>(min(limit, books));
+    ans.count = rankUnratedBooks(user, ans.similarUser, bestBooks, min(limit, books), candidateBooks);
+    ans.books = bestBooks;
 
     return ans;
 }
+
+// Method to offer other as the most similar member of m, keeping the more similar one and the lower id on ties
+static void offerNeighbour(int m, int other, int similarity, vector<int>& bestSimilarity, vector<int>& similarUser){
+    if(similarUser[m] == -1 || similarity > bestSimilarity[m] ||
+       (similarity == bestSimilarity[m] && other < similarUser[m])){
+        bestSimilarity[m] = similarity;
+        similarUser[m] = other;
+    }
+}
+
+// Method to compare every member tile row first, first + step, ... below lastTile with itself and every later
+// tile row, offering each pair of members to both of them as neighbours
+void RatingList::blockSimilarUsers(int first, int step, int lastTile, vector<int>& bestSimilarity,
+                                   vector<int>& similarUser) const{
+    DotKernel dot = dotKernel();
+    int memberTiles = (int)tileMap.size();
+    int bookTiles = tilesFor(books, TILE_BOOKS);
+
+    for(int mt = first ; mt<lastTile ; mt += step){
+
+        // The product is symmetric, so a row of tiles is only multiplied with itself and the rows after it,
+        // and every block's value goes to the members on both sides. One pair of tiles (2 x 16 KB) stays in
+        // cache while all 64 x 64 member pairs are multiplied.
+        for(int ot = mt ; ot<memberTiles ; ot++){
+            int block[TILE_MEMBERS][TILE_MEMBERS] = {{0}};
+            for(int bt = 0 ; bt<bookTiles ; bt++){
+                const int8_t* tile = tileMap[mt][bt];
+                const int8_t* otherTile = tileMap[ot][bt];
+                if(tile == nullptr || otherTile == nullptr) continue;
+                int width = min(TILE_BOOKS, books - bt*TILE_BOOKS);
+                for(int r = 0 ; r<TILE_MEMBERS && mt*TILE_MEMBERS + r < members ; r++){
+                    int m = mt*TILE_MEMBERS + r;
+                    if(!ratedBits->ratedAny(m, bt)) continue;
+                    const uint64_t* memberBits = ratedBits->blockRow(m, bt);
+
+                    // Inside the diagonal block only the pairs above the diagonal are multiplied
+                    for(int c = (ot == mt ? r + 1 : 0) ; c<TILE_MEMBERS && ot*TILE_MEMBERS + c < members ; c++){
+                        if(!RatedBits::shareBook(memberBits, ratedBits->blockRow(ot*TILE_MEMBERS + c, bt))) continue;
+                        block[r][c] += dot(tile + r*TILE_BOOKS, otherTile + c*TILE_BOOKS, width);
+                    }
+                }
+            }
+
+            for(int r = 0 ; r<TILE_MEMBERS && mt*TILE_MEMBERS + r < members ; r++){
+                int m = mt*TILE_MEMBERS + r;
+                for(int c = (ot == mt ? r + 1 : 0) ; c<TILE_MEMBERS && ot*TILE_MEMBERS + c < members ; c++){
+                    int other = ot*TILE_MEMBERS + c;
+                    offerNeighbour(m, other, block[r][c], bestSimilarity, similarUser);
+                    offerNeighbour(other, m, block[r][c], bestSimilarity, similarUser);
+                }
+            }
+        }
+    }
+}
+
+// Method to recommend at most limit books to each of the first count members in one pass
+BatchRecommendations RatingList::recommendForAll(int count, int limit){
+    BatchRecommendations result;
+    count = min(count, members);
+    limit = min(limit, books);
+    result.similarUser.assign(members, -1);
+    getPool();
+    if(sparse){
+        sparse->merge();
+    }
+
+    if(simCache){
+
+        // The cache lookup is already cheap per member, and a refresh writes to the cache
+        for(int m = 0 ; m<count ; m++){
+            result.similarUser[m] = findSimilarUser(m);
+        }
+    }
+    else if(sparse){
+
+        // The exact index search (the one exactSimilarUser makes in the sparse store) only reads the
+        // merged rows, so ranges of members run in parallel, each with its own scratch space; the
+        // approximate search is not used, so the batch gives every member its exact neighbour
+        int parts = pool ? max(1, min(count, 4 * pool->size())) : 1;
+        auto searchRange = [&](int part){
+            IndexScratch scratch;
+            int first = (int)((long long)count * part / parts);
+            int last = (int)((long long)count * (part + 1) / parts);
+            for(int m = first ; m<last ; m++){
+                result.similarUser[m] = indexSimilarUser(m, scratch);
+            }
+        };
+        if(parts > 1){
+            pool->run(parts, searchRange);
+        }
+        else{
+            searchRange(0);
+        }
+    }
+    else{
+
+        // Every part takes every parts-th row of tiles, which evens out the shrinking rows of the triangle,
+        // and keeps the best neighbour it found for every member; the parts are then combined member by
+        // member, the more similar neighbour and then the lower id first, as a single scan would pick
+        int memberTiles = tilesFor(count, TILE_MEMBERS);
+        int parts = pool ? max(1, min(memberTiles, pool->size())) : 1;
+        vector<vector<int>> partSimilarity(parts, vector<int>(members, 0));
+        vector<vector<int>> partUser(parts, vector<int>(members, -1));
+        auto blockRange = [&](int part){
+            blockSimilarUsers(part, parts, memberTiles, partSimilarity[part], partUser[part]);
+        };
+        if(parts > 1){
+            pool->run(parts, blockRange);
+        }
+        else{
+            blockRange(0);
+        }
+        vector<int> bestSimilarity(members, 0);
+        for(int part = 0 ; part<parts ; part++){
+            for(int m = 0 ; m<count ; m++){
+                if(partUser[part][m] != -1){
+                    offerNeighbour(m, partUser[part][m], partSimilarity[part][m], bestSimilarity, result.similarUser);
+                }
+            }
+        }
+    }
+    result.similarUser.resize(count);
+
+    // Rank every member's books; ranking only reads the ratings (the sparse rows were merged above), so
+    // ranges of members run in parallel
+    int parts = pool ? max(1, min(count, 4 * pool->size())) : 1;
+    vector<vector<int>> partBooks(parts), partCounts(parts);
+    auto rankRange = [&](int part){
+        int first = (int)((long long)count * part / parts);
+        int last = (int)((long long)count * (part + 1) / parts);
+        vector<int> ranked(max(limit, 1));
+        vector<int> candidates;
+        for(int m = first ; m<last ; m++){
+            int found = 0;
+            if(result.similarUser[m] != -1){
+                found = rankUnratedBooks(m, result.similarUser[m], ranked.data(), limit, candidates);
+            }
+            partBooks[part].insert(partBooks[part].end(), ranked.begin(), ranked.begin() + found);
+            partCounts[part].push_back(found);
+        }
+    };
+    if(parts > 1){
+        pool->run(parts, rankRange);
+    }
+    else if(count > 0){
+        rankRange(0);
+    }
+
+    // Join the parts in member order
+    result.start.push_back(0);
+    for(int part = 0 ; part<parts && count > 0 ; part++){
+        result.bookIds.insert(result.bookIds.end(), partBooks[part].begin(), partBooks[part].end());
+        for(int found : partCounts[part]){
+            result.start.push_back(result.start.back() + found);
+        }
+    }
+    return result;
+}
+
+// Method to order neighbours by similarity, then by lower member id
+static bool betterNeighbour(const Neighbour& a, const Neighbour& b){
+    return a.similarity > b.similarity || (a.similarity == b.similarity && a.member < b.member);
+}
+
+// Method to order book scores by score, then by lower book id
+static bool betterBook(const BookScore& a, const BookScore& b){
+    return a.score > b.score || (a.score == b.score && a.book < b.book);
+}
+
+// Method to find up to k members most similar to the user, best first (only positive similarities count)
+vector<Neighbour> RatingList::findSimilarUsers(int user, int k){
+    vector<Neighbour> heap;
+    if(k <= 0){
+        return heap;
+    }
+    if(sparse){
+        sparse->merge();
+    }
+
+    // Keep the k best in a heap whose front is the worst of them, so each member costs O(log k)
+    accumulateSimilarities(user, indexScratch);
+    for(int m : indexScratch.reached){
+        int similarity = indexScratch.similarity[m];
+        if(m == user || similarity <= 0) continue;
+        Neighbour n;
+        n.member = m;
+        n.similarity = similarity;
+        if((int)heap.size() < k){
+            heap.push_back(n);
+            push_heap(heap.begin(), heap.end(), betterNeighbour);
+        }
+        else if(betterNeighbour(n, heap.front())){
+            pop_heap(heap.begin(), heap.end(), betterNeighbour);
+            heap.back() = n;
+            push_heap(heap.begin(), heap.end(), betterNeighbour);
+        }
+    }
+    clearSimilarities(indexScratch);
+
+    sort_heap(heap.begin(), heap.end(), betterNeighbour);
+    return heap;
+}
+
+// Method to recommend up to n books the user has not rated, scored over the k most similar members
+vector<BookScore> RatingList::recommendTopBooks(int user, int k, int n){
+    vector<Neighbour> neighbours = findSimilarUsers(user, k);
+    if((int)bookScore.size() < books){
+        bookScore.resize(books, 0);
+    }
+
+    // Add each neighbour's ratings, weighted by similarity, visiting only the books they rated
+    for(const Neighbour& nb : neighbours){
+        forEachRating(nb.member, [&](int book, int rating){
+            if(bookScore[book] == 0){
+                scoredBooks.push_back(book);
+            }
+            bookScore[book] += (long long)nb.similarity * rating;
+        });
+    }
+
+    // Keep the n best books the user has not rated yet
+    vector<BookScore> heap;
+    for(int book : scoredBooks){
+        BookScore bs;
+        bs.book = book;
+        bs.score = bookScore[book];
+        bookScore[book] = 0;
+        if(bs.score <= 0 || getRating(user, book) != 0 || n <= 0) continue;
+        if((int)heap.size() < n){
+            heap.push_back(bs);
+            push_heap(heap.begin(), heap.end(), betterBook);
+        }
+        else if(betterBook(bs, heap.front())){
+            pop_heap(heap.begin(), heap.end(), betterBook);
+            heap.back() = bs;
+            push_heap(heap.begin(), heap.end(), betterBook);
+        }
+    }
+    scoredBooks.clear();
+
+    sort_heap(heap.begin(), heap.end(), betterBook);
+    return heap;
+}
@@ -12,12 +12,56 @@
 // INPUT:None directly from the user. The program initializes the rating map with the number of members and books.
 // PROCESS:The program defines a Rating struct to represent individual ratings and a RatingList class to manage a
 // list of ratings. The RatingList class provides methods to initialize the rating map, resize it dynamically,
-// and recommend books based on user ratings.
+// and recommend books based on user ratings. Ratings (-5..5) are stored as one byte each in tiles of
+// TILE_MEMBERS x TILE_BOOKS cells, row-major inside a tile, so a member's ratings are read in order.
+// Tiles are allocated on the first rating written into them; adding members or books only extends the
+// tile grid and never copies existing ratings. Next to the tiles a RatedBits bitset per member records
+// which books were rated, so overlap tests and "rated by the neighbour but not the user" lists are
+// worked out 64 books at a time without reading the ratings. Once the grid would cover more than SPARSE_SWITCH_BYTES
+// the ratings move to a SparseRatings (CSR) store.
+// A RaterIndex (book -> members who rated it) is kept next to the ratings for the neighbour search,
+// and an optional SimilarityCache turns the search for the most similar member into a lookup. An optional
+// SimHashIndex trades exactness for speed: only the members hashed into the user's buckets are compared.
+// A dirty bit per member marks the rows changed since the last save, so a save can write only those rows.
 // OUTPUT:  None directly returned by the program. The program can be extended to output recommendations
 // based on user ratings.
 
 #include<iostream>
 #include<string>
+#include<cstdint>
+#include<cstdlib>
+#include<vector>
+#include<algorithm>
+#include "SparseRatings.h"
+#include "RaterIndex.h"
+#include "ThreadPool.h"
+#include "SimilarityCache.h"
+#include "SimHashIndex.h"
+#include "RatedBits.h"
+#include "ScratchArena.h"
+
+// Number of member rows and book columns in one tile of the rating map (16 KB, fits in L1); a block of
+// the rated-book bitsets covers the same members and books
+#define TILE_MEMBERS 64
+#define TILE_BOOKS 256
+
+// Size of the dense rating map above which RatingList switches to the sparse store
+#define SPARSE_SWITCH_BYTES (64LL * 1024 * 1024)
+
+// Number of distinct values an int8 rating can take, one ranking bucket each
+#define RATING_LEVELS 256
+
+// Largest absolute rating that fits the one-byte cells of the rating map
+#define RATING_LIMIT 127
+
+// Smallest map (members x books) whose row scan is split across threads
+#define PARALLEL_MIN_CELLS (1LL << 22)
+
+// Most parts a row scan is split into (their results are kept on the scanning call's stack)
+#define SCAN_MAX_PARTS 64
+
+// Rough cost of one rater-index visit measured in dense cells scanned by the SIMD kernel
+#define INDEX_VISIT_COST 16
 
 
 using namespace std;
@@ -42,39 +86,327 @@ struct Rating{
 
 };
 
+// Struct for representing a member similar to the user
+struct Neighbour{
+
+    int member;      // Member ID
+    int similarity;  // Sum of rating products over the books both members rated
+
+};
+
+// Struct for representing a recommended book and its score
+struct BookScore{
+
+    int book;         // Book ID
+    long long score;  // Similarity-weighted sum of the neighbours' ratings for the book
+
+};
+
+// Struct for holding the recommendation of one member; the books live in the arena it was made with
+struct Recommendation{
+
+    int similarUser;   // Most similar member
+    int count;         // Number of recommended books
+    const int* books;  // Recommended books, best first, valid until the arena is reset
+
+};
+
+// Struct for the scratch space of one search through the rater index (the arrays are kept zeroed)
+struct IndexScratch{
+
+    vector<int> similarity;  // Similarity per member with the user
+    vector<char> seen;       // Flag per member reached through the index
+    vector<int> reached;     // Members reached through the index
+
+};
+
+// Struct for holding the recommendations of many members at once
+struct BatchRecommendations{
+
+    vector<int> similarUser;  // Most similar member of every member
+    vector<int> start;        // Offset of every member's books in bookIds, plus one entry for the end
+    vector<int> bookIds;      // Recommended books of all members, best first within each member
+
+};
+
 // Class for managing a list of ratings
 class RatingList{
 private:
 
-    int** ratingMap;    // 2D array to store ratings
+    vector<vector<int8_t*>> tileMap;  // Tile grid [member tile][book tile]; null tiles hold only zeros
+    SparseRatings* sparse;  // CSR rating store, used instead of tileMap once it is not null
     int members;        // Number of members
     int books;          // Number of books
+    RaterIndex* raterIndex;  // Book -> members who rated it
+    RatedBits* ratedBits;    // Books rated by every member, kept in dense mode only
+    vector<int> candidateBooks;  // Scratch list of books the neighbour rated and the user did not
+    IndexScratch indexScratch;  // Scratch space of the index search for calls made one at a time
+    vector<long long> bookScore;  // Scratch score per book for the top-K recommendation (kept zeroed)
+    vector<int> scoredBooks;      // Scratch list of books given a score
+    SimilarityCache* simCache;  // Cached member-pair similarities, or null when the cache is off
+    SimHashIndex* hashIndex;    // Hash index for the approximate search, or null when the search is exact
+    vector<int> hashCandidates; // Scratch list of candidate neighbours from the hash index
+    vector<uint64_t> dirtyRows; // Bit m is set once member m's ratings changed, until clearDirty
+    ThreadPool* pool;        // Threads for the row scan, started on the first large scan
+    int threadCount;         // Number of scan threads (0 uses every hardware thread)
+
+    static const int8_t zeroSegment[TILE_BOOKS];  // Row segment returned for tiles not allocated yet
+
+    // Method to get the number of tiles needed to cover n rows or columns
+    static int tilesFor(int n, int tileSize){
+        return (n + tileSize - 1) / tileSize;
+    }
+
+    // Method to extend the tile grid to the current number of members and books
+    void growTiles();
+
+    // Method to free every tile of the grid
+    void freeTiles();
+
+    // Method to move all ratings from the dense map into the sparse store
+    void convertToSparse();
+
+    // Method to scan the member tile rows [firstTile, lastTile) for the member most similar to the user
+    void scanTileRows(int user, int firstTile, int lastTile, int& maxSimilarity, int& similarUser) const;
+
+    // Method to find the most similar member by comparing the user's row with every row
+    int scanSimilarUser(int user);
+
+    // Method to add up, in the scratch space, the similarity of the user with every member reached through
+    // the rater index (rows must be merged; calls running at the same time each need their own scratch)
+    void accumulateSimilarities(int user, IndexScratch& scratch) const;
+
+    // Method to reset the scratch space after accumulateSimilarities
+    static void clearSimilarities(IndexScratch& scratch);
+
+    // Method to find the most similar member through the rater index
+    int indexSimilarUser(int user, IndexScratch& scratch) const;
+
+    // Method to update the cached similarities of a member with the other raters of a book before a rating change
+    void updateSimilarities(int member, int book, int rating);
+
+    // Method to compare every member tile row first, first + step, ... below lastTile with itself and every
+    // later tile row, offering each pair of members to both of them as neighbours
+    void blockSimilarUsers(int first, int step, int lastTile, vector<int>& bestSimilarity,
+                           vector<int>& similarUser) const;
+
+    // Method to get the similarity of two members from their rows
+    int pairSimilarity(int a, int b) const;
+
+    // Method to find the most similar member exactly, choosing the cheaper of the two searches
+    int exactSimilarUser(int user);
+
+    // Method to find a similar member among the hash index candidates, falling back to the exact search
+    int approxSimilarUser(int user);
+
+    // Method to find the most similar member with the cache, the hash index or the exact search
+    int findSimilarUser(int user);
 
 public:
 
-    // Constructor to initialize the rating map with the number of members and books
-    RatingList(int m, int b){
+    // Constructor to initialize the rating map with the number of members and books.
+    // Tiles are allocated lazily, so nothing is zero-filled up front.
+    // Passing useSparse starts directly with the sparse store.
+    RatingList(int m, int b, bool useSparse = false){
         members = m;
         books = b;
-        ratingMap = new int*[members];
-        for(int i = 0 ; i<members ; i++){
-            ratingMap[i] = new int[books];
-            for(int j = 0 ; j<books; j++){
-                ratingMap[i][j] = 0;
-            }
+        sparse = nullptr;
+        raterIndex = new RaterIndex(books);
+        ratedBits = nullptr;
+        simCache = nullptr;
+        hashIndex = nullptr;
+        pool = nullptr;
+        threadCount = 0;
+        dirtyRows.assign((members + BITS_PER_WORD - 1) / BITS_PER_WORD, 0);
+        if(useSparse || (long long)members * books > SPARSE_SWITCH_BYTES){
+            sparse = new SparseRatings(members);
+        }
+        else{
+            growTiles();
+            ratedBits = new RatedBits(members, books);
         }
     }
 
     // Destructor to deallocate memory for the rating map
     ~RatingList(){
-        for(int i = 0 ; i<members ; i++){
-            delete[] ratingMap[i];
+        freeTiles();
+        delete sparse;
+        delete raterIndex;
+        delete ratedBits;
+        delete simCache;
+        delete hashIndex;
+        delete pool;
+    }
+
+    // Method to turn the member similarity cache on (built from the current ratings) or off; turning it
+    // on turns the approximate search off
+    void setSimilarityCache(bool on);
+
+    // Method to turn the approximate search on with the given hash tables and bits (0 tables turns it off);
+    // the cache and the approximate search are exclusive, so turning the search on turns the cache off
+    void setApproximateSearch(int tables, int bits);
+
+    // Method to measure how often the approximate search finds a member as similar as the exact one,
+    // over samples members spread across the first count members who rated something
+    double recallAtOne(int count, int samples);
+
+    // Method to set the number of threads used by the row scan (0 uses every hardware thread)
+    void setThreadCount(int threads){
+        if(threads != threadCount){
+            delete pool;
+            pool = nullptr;
+            threadCount = threads;
         }
-        delete[] ratingMap;
     }
 
-    // Method to get the rating map
-    int** getRatingMap();
+    // Method to get the thread pool, started on first use (null when one thread is set), so the models
+    // built on the ratings run on the same threads instead of starting their own
+    ThreadPool* getPool(){
+        if(pool == nullptr && threadCount != 1){
+            pool = new ThreadPool(threadCount);
+        }
+        return pool;
+    }
+
+    // Method to check whether ratings are kept in the sparse store
+    bool isSparse() const{
+        return sparse != nullptr;
+    }
+
+    // Method to get the rating of a member for a book
+    int getRating(int member, int book) const{
+        if(sparse){
+            return sparse->get(member, book);
+        }
+        return rowSegment(member, book / TILE_BOOKS)[book % TILE_BOOKS];
+    }
+
+    // Method to set the rating of a member for a book, ignoring cells outside the map (the rating must be
+    // within RATING_LIMIT of zero)
+    void setRating(int member, int book, int rating){
+        if(member < 0 || member >= members || book < 0 || book >= books){
+            return;
+        }
+        dirtyRows[member / BITS_PER_WORD] |= 1ULL << (member % BITS_PER_WORD);
+        if(simCache){
+            updateSimilarities(member, book, rating);
+        }
+        if(hashIndex){
+            hashIndex->update(member, book, getRating(member, book), rating);
+        }
+        raterIndex->update(member, book, rating);
+        if(sparse){
+            sparse->set(member, book, rating);
+            return;
+        }
+        ratedBits->set(member, book, rating != 0);
+        int8_t*& tile = tileMap[member / TILE_MEMBERS][book / TILE_BOOKS];
+        if(tile == nullptr){
+            if(rating == 0){
+                return;
+            }
+            tile = (int8_t*)calloc(TILE_MEMBERS * TILE_BOOKS, 1);
+        }
+        tile[(member % TILE_MEMBERS) * TILE_BOOKS + book % TILE_BOOKS] = (int8_t)rating;
+    }
+
+    // Method to add whole rows of ratings at once: member firstMember + i rated bookIds[k] with values[k]
+    // for k in [rowStart[i], rowStart[i + 1]), all non-zero; cells outside the map are ignored, and a
+    // later cell of a row replaces an earlier one for the same book
+    void addRows(int firstMember, int count, const uint64_t* rowStart, const int32_t* bookIds, const int8_t* values);
+
+    // Method to get a read-only pointer to TILE_BOOKS ratings of a member starting at a book tile (dense mode only)
+    const int8_t* rowSegment(int member, int bookTile) const{
+        const int8_t* tile = tileMap[member / TILE_MEMBERS][bookTile];
+        if(tile == nullptr){
+            return zeroSegment;
+        }
+        return tile + (member % TILE_MEMBERS) * TILE_BOOKS;
+    }
+
+    // Method to get the number of books the rating map covers
+    int getBookCapacity() const{
+        return books;
+    }
+
+    // Method to get the members who rated a book
+    const vector<Rater>& ratersOf(int book) const{
+        return raterIndex->ratersOf(book);
+    }
+
+    // Method to count the books both members rated (call flushPending first in sparse mode)
+    int coRatedCount(int a, int b) const;
+
+    // Method to count the ratings stored in the map
+    long long countRatings() const{
+        long long total = 0;
+        for(int b = 0 ; b<books ; b++){
+            total += raterIndex->ratersOf(b).size();
+        }
+        return total;
+    }
+
+    // Method to get a checksum of every (member, book, rating), the same whatever order they were added in
+    uint64_t checksum() const;
+
+    // Method to merge buffered sparse ratings so rows can be read, from several threads if needed
+    void flushPending(){
+        if(sparse){
+            sparse->merge();
+        }
+    }
+
+    // Method to call visit(book, rating) for every book a member rated, in book order (call flushPending first)
+    template<typename Visit>
+    void forEachRating(int member, Visit visit) const{
+        if(sparse){
+            const int* rated = sparse->rowBooks(member);
+            const int8_t* values = sparse->rowValues(member);
+            for(int i = 0 ; i<sparse->rowLength(member) ; i++){
+                visit(rated[i], (int)values[i]);
+            }
+            return;
+        }
+
+        // The bitset points straight at the rated cells, so unrated cells and empty tiles are never read
+        for(int w = 0 ; w<ratedBits->getWords() ; w++){
+            const uint64_t* rated = ratedBits->blockRow(member, w / RATED_BLOCK_WORDS);
+            uint64_t bits = rated ? rated[w % RATED_BLOCK_WORDS] : 0;
+            if(bits == 0) continue;
+            int first = w * BITS_PER_WORD;
+            const int8_t* segment = rowSegment(member, first / TILE_BOOKS) + first % TILE_BOOKS;
+            while(bits != 0){
+                int j = __builtin_ctzll(bits);
+                visit(first + j, (int)segment[j]);
+                bits &= bits - 1;
+            }
+        }
+    }
+
+    // Method to grow the rating map to at least m members and b books in one step
+    void reserve(int m, int b);
+
+    // Method to check whether a member's ratings changed since the last clearDirty
+    bool isDirty(int member) const{
+        return (dirtyRows[member / BITS_PER_WORD] >> (member % BITS_PER_WORD)) & 1;
+    }
+
+    // Method to call visit(member) for every member whose ratings changed since the last clearDirty
+    template<typename Visit>
+    void forEachDirty(Visit visit) const{
+        for(size_t w = 0 ; w<dirtyRows.size() ; w++){
+            uint64_t bits = dirtyRows[w];
+            while(bits != 0){
+                visit((int)(w * BITS_PER_WORD + __builtin_ctzll(bits)));
+                bits &= bits - 1;
+            }
+        }
+    }
+
+    // Method to forget which members changed, once their rows are saved
+    void clearDirty(){
+        fill(dirtyRows.begin(), dirtyRows.end(), 0);
+    }
 
     // Method to resize the rating map when the number of members changes
     void resizeMembers();
@@ -82,8 +414,24 @@ public:
     // Method to resize the rating map when the number of books changes
     void resizeBooks();
 
-    // Method to recommend books based on user ratings
-    int** recomendBook(int user);
+    // Method to rank up to limit books the user has not rated but the neighbour has, best rated first
+    // (candidates is scratch space for the call, so calls running at the same time each need their own)
+    int rankUnratedBooks(int user, int neighbour, int* ranked, int limit, vector<int>& candidates);
+
+    // Method to recommend books based on user ratings, with the books taken from the arena
+    Recommendation recomendBook(int user, ScratchArena& arena);
+
+    // Method to recommend at most limit books based on user ratings, with the books taken from the arena
+    Recommendation recomendBook(int user, int limit, ScratchArena& arena);
+
+    // Method to recommend at most limit books to each of the first count members in one pass
+    BatchRecommendations recommendForAll(int count, int limit);
+
+    // Method to find up to k members most similar to the user, best first (only positive similarities count)
+    vector<Neighbour> findSimilarUsers(int user, int k);
+
+    // Method to recommend up to n books the user has not rated, scored over the k most similar members
+    vector<BookScore> recommendTopBooks(int user, int k, int n);
 
 };
 
@@ -0,0 +1,228 @@
+
+// AUTHOR: Shikha Pallavi
+// PROGRAM: RatingsFile.cpp
+// DATE: 10/16/2026
+
+// PURPOSE: This file contains the implementation of the in-place saver of the ratings text file.
+
+// INPUT: save takes the path of the ratings file, the member list with its count, the number of books
+// and the rating list.
+
+// PROCESS: A ratings line is built from a line of zero cells with the member's ratings written over it,
+// so a row costs as much as its ratings. probe maps the file and walks it name line by ratings line,
+// checking every name against the session's members and every ratings line against the length of the
+// first one; it reads two short spans per member and never the ratings themselves. The patched rows and
+// the appended members go out with pwrite and one fdatasync. A full rewrite goes to a temporary file that
+// is synced and renamed over the old one, and the directory is synced after the rename (replaceFile).
+
+// OUTPUT: The ratings file. save returns the number of rows written, or -1 if the file could not be written.
+
+#include<iostream>
+#include<string>
+#include<fstream>
+#include<cstring>
+#include<cstdio>
+#include<cstdlib>
+#include<fcntl.h>
+#include<unistd.h>
+#include "RatingsFile.h"
+#include "MappedFile.h"
+#include "FileSync.h"
+
+
+using namespace std;
+
+// Method to get the number of characters a rating takes
+int RatingsFile::cellWidth(int rating){
+    int chars = rating < 0 ? 2 : 1;
+    for(int v = abs(rating) ; v >= 10 ; v /= 10){
+        chars++;
+    }
+    return chars;
+}
+
+// Method to write a member's ratings line into row (numBooks cells and the newline), returning false
+// if some rating does not fit in the cell width
+bool RatingsFile::formatRow(const RatingList& ratings, int member, string& row){
+    size_t length = (size_t)numBooks * (width + 1) + 1;
+    if(blankRow.size() != length){
+        blankRow.assign(length, ' ');
+        for(int j = 0 ; j<numBooks ; j++){
+            blankRow[(size_t)j * (width + 1) + width - 1] = '0';
+        }
+        blankRow[length - 1] = '\n';
+    }
+
+    // Only the rated cells differ from the blank line
+    row = blankRow;
+    bool fits = true;
+    ratings.forEachRating(member, [&](int book, int rating){
+        if(book >= numBooks){
+            return;
+        }
+        string text = to_string(rating);
+        if((int)text.size() > width){
+            fits = false;
+            return;
+        }
+        memcpy(&row[(size_t)book * (width + 1) + width - text.size()], text.data(), text.size());
+    });
+    return fits;
+}
+
+// Method to read the layout of an existing file, returning false if it cannot be patched in place
+bool RatingsFile::probe(string filePath, const MemberList& members, int numMembers){
+    path.clear();
+    rowOffsets.clear();
+    MappedFile file;
+    string error;
+    if(!file.open(filePath, error)){
+        return false;
+    }
+    const char* data = file.data();
+    long long size = file.size();
+
+    // The first ratings line gives the number of books and the cell width; every other line must match it
+    long long at = 0;
+    long long rowLength = -1;
+    for(int i = 0 ; at < size ; i++){
+        if(i >= numMembers){
+            return false;
+        }
+        PooledString name = members.getName(i);
+        if(at + (long long)name.size() + 1 > size || memcmp(data + at, name.data(), name.size()) != 0 ||
+           data[at + name.size()] != '\n'){
+            return false;
+        }
+        at += name.size() + 1;
+        if(rowLength < 0){
+            const char* eol = (const char*)memchr(data + at, '\n', size - at);
+            if(eol == nullptr){
+                return false;
+            }
+            rowLength = eol - (data + at);
+            int cells = 0;
+            for(const char* p = data + at ; p < eol ; p++){
+                if(*p != ' ' && (p == data + at || p[-1] == ' ')){
+                    cells++;
+                }
+            }
+            if(cells == 0 || rowLength % cells != 0 || rowLength / cells < 2){
+                return false;
+            }
+            numBooks = cells;
+            width = rowLength / cells - 1;
+            for(int j = 0 ; j<numBooks ; j++){
+                if(data[at + (long long)j * (width + 1) + width] != ' '){
+                    return false;
+                }
+            }
+        }
+        if(at + rowLength + 1 > size || data[at + rowLength] != '\n'){
+            return false;
+        }
+        rowOffsets.push_back(at);
+        at += rowLength + 1;
+    }
+    path = filePath;
+    fileBytes = size;
+    return true;
+}
+
+// Method to write the whole file, returning false if it could not be written
+bool RatingsFile::writeAll(string filePath, const MemberList& members, int numMembers, int books,
+                           const RatingList& ratings){
+    path.clear();
+    rowOffsets.clear();
+
+    // The widest rating sets the cell width of the whole file
+    numBooks = books;
+    width = RATING_CELL_WIDTH;
+    for(int i = 0 ; i<numMembers ; i++){
+        ratings.forEachRating(i, [&](int book, int rating){
+            if(book < books){
+                width = max(width, cellWidth(rating));
+            }
+        });
+    }
+
+    string tempPath = filePath + ".tmp";
+    ofstream outputFile(tempPath, ios::binary);
+    if(!outputFile){
+        return false;
+    }
+    long long at = 0;
+    string row;
+    for(int i = 0 ; i<numMembers ; i++){
+        outputFile<<members.getName(i)<<"\n";
+        at += members.getName(i).size() + 1;
+        rowOffsets.push_back(at);
+        formatRow(ratings, i, row);
+        outputFile.write(row.data(), row.size());
+        at += row.size();
+    }
+    outputFile.close();
+
+    // Synced before the rename, so the old file is only replaced by a complete one, and the directory after it
+    if(!outputFile || !replaceFile(tempPath, filePath)){
+        remove(tempPath.c_str());
+        rowOffsets.clear();
+        return false;
+    }
+    path = filePath;
+    fileBytes = at;
+    return true;
+}
+
+// Method to save the ratings of numMembers members on numBooks books, returning the number of rows
+// written (-1 if the file could not be written). Dirty rows are cleared once they are on disk.
+long long RatingsFile::save(string filePath, const MemberList& members, int numMembers, int books,
+                            RatingList& ratings){
+    bool patch = (filePath == path || probe(filePath, members, numMembers)) && books == numBooks;
+    int fd = patch ? ::open(filePath.c_str(), O_WRONLY) : -1;
+    if(fd >= 0){
+        long long written = 0;
+        bool ok = true;
+        string row;
+
+        // Changed rows are overwritten where they are
+        int inFile = (int)rowOffsets.size();
+        ratings.forEachDirty([&](int member){
+            if(!ok || member >= inFile){
+                return;
+            }
+            ok = formatRow(ratings, member, row) &&
+                 pwrite(fd, row.data(), row.size(), rowOffsets[member]) == (ssize_t)row.size();
+            written++;
+        });
+
+        // Members added since the last save go at the end
+        string tail;
+        for(int i = inFile ; ok && i<numMembers ; i++){
+            PooledString name = members.getName(i);
+            tail.append(name.data(), name.size());
+            tail += '\n';
+            rowOffsets.push_back(fileBytes + tail.size());
+            ok = formatRow(ratings, i, row);
+            tail += row;
+            written++;
+        }
+        if(ok && !tail.empty()){
+            ok = pwrite(fd, tail.data(), tail.size(), fileBytes) == (ssize_t)tail.size();
+            fileBytes += tail.size();
+        }
+        ok = ok && fdatasync(fd) == 0;
+        ::close(fd);
+        if(ok){
+            ratings.clearDirty();
+            return written;
+        }
+    }
+
+    // The layout cannot be patched (or a patch failed), so the whole file is written again
+    if(!writeAll(filePath, members, numMembers, books, ratings)){
+        return -1;
+    }
+    ratings.clearDirty();
+    return numMembers;
+}
@@ -0,0 +1,73 @@
+//
+// Created by Shikha Pallavi on 10/16/26.
+//
+
+#ifndef P1X_RATINGSFILE_H
+#define P1X_RATINGSFILE_H
+
+// AUTHOR: Shikha Pallavi
+// PROGRAM: RatingsFile.h
+// DATE: 10/16/2026
+// PURPOSE: Header file for saving the ratings text file so that a save only writes the rows that changed.
+// INPUT: None directly from the user. The session passes the path, the members and the rating list.
+// PROCESS: Every rating is written right-aligned in the same number of characters and followed by a space,
+// so every rating row of a file has the same length and a row can be overwritten in place with pwrite.
+// The file stays a plain ratings file: a name line, then a ratings line, for every member. The first save
+// of a run checks that the file on disk has this layout and holds the session's members in order; from
+// then on the offset of every row is known. A save then writes the rows the rating list marked dirty and
+// appends the members added since. The whole file is rewritten when its layout cannot be used, when
+// the number of books changed (every row gets longer) or when a rating no longer fits in the cell width.
+// OUTPUT: The ratings file. save reports how many rows it wrote.
+
+#include<iostream>
+#include<string>
+#include<vector>
+#include "MemberList.h"
+#include "RatingList.h"
+
+// Characters every rating is right-aligned in, unless a rating needs more ("-5" needs two)
+#define RATING_CELL_WIDTH 2
+
+
+using namespace std;
+
+// Class for saving a ratings file in place
+class RatingsFile{
+private:
+
+    string path;                   // File the layout below describes, empty until it is known
+    int width;                     // Characters every rating is right-aligned in
+    int numBooks;                  // Ratings on every row
+    vector<long long> rowOffsets;  // File offset of every member's ratings line
+    long long fileBytes;           // Size of the file
+    string blankRow;               // Ratings line of a member who rated nothing
+
+    // Method to get the number of characters a rating takes
+    static int cellWidth(int rating);
+
+    // Method to write a member's ratings line into row (numBooks cells and the newline), returning false
+    // if some rating does not fit in the cell width
+    bool formatRow(const RatingList& ratings, int member, string& row);
+
+    // Method to read the layout of an existing file, returning false if it cannot be patched in place
+    bool probe(string filePath, const MemberList& members, int numMembers);
+
+    // Method to write the whole file, returning false if it could not be written
+    bool writeAll(string filePath, const MemberList& members, int numMembers, int books, const RatingList& ratings);
+
+public:
+
+    // Constructor to create a saver that knows no file yet
+    RatingsFile(){
+        width = RATING_CELL_WIDTH;
+        numBooks = 0;
+        fileBytes = 0;
+    }
+
+    // Method to save the ratings of numMembers members on numBooks books, returning the number of rows
+    // written (-1 if the file could not be written). Dirty rows are cleared once they are on disk.
+    long long save(string filePath, const MemberList& members, int numMembers, int books, RatingList& ratings);
+
+};
+
+#endif //P1X_RATINGSFILE_H
@@ -0,0 +1,80 @@
+
+// AUTHOR: Shikha Pallavi
+// PROGRAM: ScratchArena.cpp
+// DATE: 10/16/2026
+
+// PURPOSE: This file contains the implementation of the scratch arena.
+
+// INPUT: grow takes the number of bytes that did not fit in the current block.
+
+// PROCESS: grow starts a block twice as large as the last one, or as large as the request if that is more.
+// The blocks are 16-byte aligned because they come from operator new[] on a char array sized in multiples
+// of ARENA_ALIGN. reset frees the blocks and takes one block of their total size when more than one was used,
+// otherwise it only rewinds the pointer.
+
+// OUTPUT: None directly. The arena's blocks hold the arrays handed out.
+
+#include<iostream>
+#include<string>
+#include<new>
+#include<algorithm>
+#include "ScratchArena.h"
+
+
+using namespace std;
+
+// Constructor to create an arena with one block of the given size
+ScratchArena::ScratchArena(size_t initialBytes){
+    heapBlocks = 0;
+    used = 0;
+    blocks.reserve(64);
+    blockBytes.reserve(64);
+    size_t bytes = (initialBytes + ARENA_ALIGN - 1) / ARENA_ALIGN * ARENA_ALIGN;
+    blocks.push_back(static_cast<char*>(::operator new(bytes > 0 ? bytes : ARENA_ALIGN)));
+    blockBytes.push_back(bytes > 0 ? bytes : ARENA_ALIGN);
+    heapBlocks++;
+}
+
+// Destructor to free every block
+ScratchArena::~ScratchArena(){
+    for(char* block : blocks){
+        ::operator delete(block);
+    }
+}
+
+// Method to start a block with room for at least n bytes
+void ScratchArena::grow(size_t n){
+    size_t bytes = max(2 * blockBytes.back(), n);
+    blocks.push_back(static_cast<char*>(::operator new(bytes)));
+    blockBytes.push_back(bytes);
+    heapBlocks++;
+    used = 0;
+}
+
+// Method to take back every array handed out since the last reset
+void ScratchArena::reset(){
+    used = 0;
+    if(blocks.size() == 1){
+        return;
+    }
+
+    // The last request needed every block, so the next one gets them as a single block
+    size_t total = capacityBytes();
+    for(char* block : blocks){
+        ::operator delete(block);
+    }
+    blocks.clear();
+    blockBytes.clear();
+    blocks.push_back(static_cast<char*>(::operator new(total)));
+    blockBytes.push_back(total);
+    heapBlocks++;
+}
+
+// Method to get the bytes the arena holds
+size_t ScratchArena::capacityBytes() const{
+    size_t total = 0;
+    for(size_t bytes : blockBytes){
+        total += bytes;
+    }
+    return total;
+}
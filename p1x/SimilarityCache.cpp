@@ -0,0 +1,247 @@
+
+// AUTHOR: Shikha Pallavi
+// PROGRAM: SimilarityCache.cpp
+// DATE: 10/16/2026
+
+// PURPOSE: This file contains the implementation of the member similarity cache.
+
+// INPUT: add takes two members and the change in their similarity; refresh takes a member and the exact
+// similarities of the members it shares a book with; bestNeighbour takes a member id.
+
+// PROCESS: The triangular table grows by appending the pairs of the new members, so existing pairs never
+// move. A member's best neighbour in table mode stays right while it only gains, is replaced by a pair
+// that overtakes it, and is looked up again in the member's row when it loses. When the member count
+// passes SIM_TABLE_MAX_MEMBERS every row of the table is cut down to its SIM_TOP_K best positive pairs.
+// A pair on either member's list is known exactly, so a change to it is applied to both lists: it goes
+// on a list with room or one whose worst neighbour it beats (the pushed-off neighbour raising the
+// ceiling), and comes off a list once it is no longer positive. A pair on neither list can only have
+// gone up by the change, so the ceilings of both members go up by as much. bestNeighbour follows the same
+// rule as the full scan in RatingList: the highest similarity wins and ties go to the lowest member id.
+
+// OUTPUT: None directly. The methods keep the cached similarities and return the best neighbour.
+
+#include<iostream>
+#include<string>
+#include<algorithm>
+#include "SimilarityCache.h"
+
+
+using namespace std;
+
+// Method to order neighbours by similarity, then by lower member id
+static bool betterCached(const CachedNeighbour& a, const CachedNeighbour& b){
+    return a.similarity > b.similarity || (a.similarity == b.similarity && a.member < b.member);
+}
+
+// Constructor to create a cache of zero similarities for m members
+SimilarityCache::SimilarityCache(int m){
+    members = 0;
+    useTable = true;
+    growMembers(m);
+}
+
+// Method to cover m members; new members start with zero similarity to everyone
+void SimilarityCache::growMembers(int m){
+    if(m <= members){
+        return;
+    }
+    int before = members;
+    members = m;
+    if(useTable && members > SIM_TABLE_MAX_MEMBERS){
+        members = before;
+        convertToLists();
+        members = m;
+    }
+    if(useTable){
+        table.resize(slot(0, members), 0);
+
+        // A new member (similarity 0) beats every best neighbour that is negative
+        for(int i = 0 ; i<before ; i++){
+            if(bestOf[i] != -1 && table[slot(i, bestOf[i])] < 0){
+                bestOf[i] = -1;
+            }
+        }
+        bestOf.resize(members, -1);
+    }
+    else{
+        lists.resize((size_t)members * SIM_TOP_K);
+        listSizes.resize(members, 0);
+        ceilings.resize(members, 0);
+    }
+}
+
+// Method to move the table into per-member lists
+void SimilarityCache::convertToLists(){
+    lists.assign((size_t)members * SIM_TOP_K, CachedNeighbour());
+    listSizes.assign(members, 0);
+    ceilings.assign(members, 0);
+    vector<CachedNeighbour> row;
+    for(int a = 0 ; a<members ; a++){
+        row.clear();
+        for(int b = 0 ; b<members ; b++){
+            if(b != a && table[slot(a, b)] > 0){
+                row.push_back({b, table[slot(a, b)]});
+            }
+        }
+        int kept = min((int)row.size(), SIM_TOP_K);
+        partial_sort(row.begin(), row.begin() + kept, row.end(), betterCached);
+        copy(row.begin(), row.begin() + kept, lists.begin() + (size_t)a * SIM_TOP_K);
+        listSizes[a] = kept;
+        for(size_t i = kept ; i<row.size() ; i++){
+            ceilings[a] = max(ceilings[a], row[i].similarity);
+        }
+    }
+    vector<int>().swap(table);
+    vector<int>().swap(bestOf);
+    useTable = false;
+}
+
+// Method to find b on a's list, or get null
+CachedNeighbour* SimilarityCache::find(int a, int b){
+    CachedNeighbour* list = &lists[(size_t)a * SIM_TOP_K];
+    for(int i = 0 ; i<listSizes[a] ; i++){
+        if(list[i].member == b){
+            return &list[i];
+        }
+    }
+    return nullptr;
+}
+
+// Method to set the exact similarity of b on a's list, taking b off it or putting b on it as needed
+void SimilarityCache::place(int a, int b, int similarity, CachedNeighbour* entry){
+    CachedNeighbour* list = &lists[(size_t)a * SIM_TOP_K];
+    if(entry){
+        if(similarity > 0){
+            entry->similarity = similarity;
+        }
+        else{
+            *entry = list[--listSizes[a]];
+        }
+        return;
+    }
+    if(similarity <= 0){
+        return;
+    }
+    CachedNeighbour added = {b, similarity};
+    if(listSizes[a] < SIM_TOP_K){
+        list[listSizes[a]++] = added;
+        return;
+    }
+
+    // A full list keeps the better of its worst neighbour and b; the other one is left off
+    CachedNeighbour* worst = list;
+    for(int i = 1 ; i<SIM_TOP_K ; i++){
+        if(betterCached(*worst, list[i])){
+            worst = &list[i];
+        }
+    }
+    if(betterCached(added, *worst)){
+        swap(added, *worst);
+    }
+    ceilings[a] = max(ceilings[a], added.similarity);
+}
+
+// Method to keep the best neighbour of a in table mode after the pair with b changed by delta
+void SimilarityCache::updateBest(int a, int b, int delta){
+    int best = bestOf[a];
+    if(best == -1){
+        return;
+    }
+    if(best == b){
+        if(delta < 0){
+            bestOf[a] = -1;
+        }
+        return;
+    }
+    int similarity = table[slot(a, b)];
+    int bestSimilarity = table[slot(a, best)];
+    if(similarity > bestSimilarity || (similarity == bestSimilarity && b < best)){
+        bestOf[a] = b;
+    }
+}
+
+// Method to add delta to the similarity of two different members
+void SimilarityCache::add(int a, int b, int delta){
+    if(a == b || delta == 0){
+        return;
+    }
+    if(useTable){
+        table[slot(a, b)] += delta;
+        updateBest(a, b, delta);
+        updateBest(b, a, delta);
+        return;
+    }
+
+    // The pair is known exactly if it is on either list
+    CachedNeighbour* onA = find(a, b);
+    CachedNeighbour* onB = find(b, a);
+    if(onA || onB){
+        int similarity = (onA ? onA->similarity : onB->similarity) + delta;
+        place(a, b, similarity, onA);
+        place(b, a, similarity, onB);
+    }
+    else if(delta > 0){
+        ceilings[a] += delta;
+        ceilings[b] += delta;
+    }
+}
+
+// Method to replace what is kept for a member (its row of the table, or its list) with the exact
+// similarities given for the members in reached (members not in reached have similarity 0)
+void SimilarityCache::refresh(int user, const vector<int>& reached, const vector<int>& similarity){
+    if(useTable){
+        for(int i = 0 ; i<members ; i++){
+            if(i != user){
+                table[slot(user, i)] = 0;
+            }
+        }
+        for(int m : reached){
+            if(m != user){
+                table[slot(user, m)] = similarity[m];
+            }
+        }
+
+        // Any member's best neighbour may have been one of the pairs just rewritten
+        bestOf.assign(members, -1);
+        return;
+    }
+    listSizes[user] = 0;
+    ceilings[user] = 0;
+    for(int m : reached){
+        if(m != user){
+            place(user, m, similarity[m], nullptr);
+        }
+    }
+}
+
+// Method to get the member most similar to the user, lowest id first on ties, or -1 when the cache
+// cannot tell (the user's list needs a refresh, or the user has no positive neighbour)
+int SimilarityCache::bestNeighbour(int user){
+    if(useTable){
+        if(bestOf[user] == -1){
+            int maxSimilarity = -1;
+            for(int i = 0 ; i<members ; i++){
+                if(i == user) continue;
+                int similarity = table[slot(user, i)];
+                if(similarity > maxSimilarity || bestOf[user] == -1){
+                    maxSimilarity = similarity;
+                    bestOf[user] = i;
+                }
+            }
+        }
+        return bestOf[user];
+    }
+
+    // The best listed neighbour is the answer only if no member left off the list can reach it
+    const CachedNeighbour* list = &lists[(size_t)user * SIM_TOP_K];
+    const CachedNeighbour* best = nullptr;
+    for(int i = 0 ; i<listSizes[user] ; i++){
+        if(best == nullptr || betterCached(list[i], *best)){
+            best = &list[i];
+        }
+    }
+    if(best == nullptr || best->similarity <= ceilings[user]){
+        return -1;
+    }
+    return best->member;
+}
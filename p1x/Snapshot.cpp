@@ -0,0 +1,276 @@
+
+// AUTHOR: Shikha Pallavi
+// PROGRAM: Snapshot.cpp
+// DATE: 10/16/2026
+
+// PURPOSE: This file contains the implementation of the binary snapshot reader and writer.
+
+// INPUT: open takes the path of a snapshot file. write takes the path to write to, the book and member
+// lists with their counts, and the rating list.
+
+// PROCESS: write copies the string pool's chunks as they are, fills the fixed-width records with the
+// handles of their strings and the hashes the lists keep for them, and writes the ratings as compressed
+// sparse rows taken member by member from the rating list, so it costs as much as the ratings stored. The
+// file is written under a temporary name, synced and renamed over the old snapshot, and the directory is
+// synced (replaceFile), so a crash never leaves a half-written snapshot behind and a successful write is
+// on disk before the caller empties the change log. open maps the whole file read-only (MappedFile) and checks the
+// magic tag, the version, that every section lies inside the file, that every chunk holds whole string
+// records, that every handle points inside its chunk and that the row offsets only grow, before any record
+// is handed out.
+
+// OUTPUT: write produces the snapshot file. open returns whether the file can be used and, if not, why.
+
+#include<iostream>
+#include<string>
+#include<fstream>
+#include<vector>
+#include<cstring>
+#include<cstdio>
+#include "Snapshot.h"
+#include "FileSync.h"
+
+
+using namespace std;
+
+// Method to map a snapshot file and check its header, returning false (with a reason) if it cannot be used
+bool Snapshot::open(string filePath, string& error){
+    close();
+    if(!file.open(filePath, error)){
+        return false;
+    }
+    if(file.size() < sizeof(SnapshotHeader)){
+        file.close();
+        error = filePath + " is too short to be a snapshot";
+        return false;
+    }
+    base = file.data();
+    uint64_t length = file.size();
+    header = (const SnapshotHeader*)base;
+
+    // Check the header before trusting any offset in it (every count is far below 2^32 in a valid file,
+    // so none of the sums below can wrap)
+    uint64_t strings = 0;
+    if(memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(header->magic)) != 0){
+        error = filePath + " is not a snapshot";
+    }
+    else if(header->version != SNAPSHOT_VERSION){
+        error = filePath + " has snapshot version " + to_string(header->version) +
+                ", expected " + to_string(SNAPSHOT_VERSION);
+    }
+    else if(header->numChunks == 0 || header->numChunks > ((uint64_t)1 << (32 - STRING_CHUNK_BITS)) ||
+            header->numRatings > length || header->stringBytes > length ||
+            header->stringOffset + header->stringBytes > length ||
+            header->chunkOffset + ((uint64_t)header->numChunks + 1) * sizeof(uint64_t) > length ||
+            header->bookOffset + (uint64_t)header->numBooks * sizeof(SnapshotBook) > length ||
+            header->memberOffset + (uint64_t)header->numMembers * sizeof(SnapshotMember) > length ||
+            header->rowOffset + ((uint64_t)header->numMembers + 1) * sizeof(uint64_t) > length ||
+            header->ratingBookOffset + header->numRatings * sizeof(int32_t) > length ||
+            header->ratingValueOffset + header->numRatings > length){
+        error = filePath + " is truncated";
+    }
+    else{
+        chunkTable = (const uint64_t*)(base + header->chunkOffset);
+        bookRecords = (const SnapshotBook*)(base + header->bookOffset);
+        memberRecords = (const SnapshotMember*)(base + header->memberOffset);
+        rowStarts = (const uint64_t*)(base + header->rowOffset);
+        ratingBooks = (const int32_t*)(base + header->ratingBookOffset);
+        ratingValues = (const int8_t*)(base + header->ratingValueOffset);
+
+        // Every handle must point at a string inside its chunk
+        bool stringsFit = checkChunks(strings) && strings == header->numStrings;
+        for(uint32_t i = 0 ; i<header->numBooks && stringsFit ; i++){
+            stringsFit = validHandle(bookRecords[i].author) && validHandle(bookRecords[i].title);
+        }
+        for(uint32_t i = 0 ; i<header->numMembers && stringsFit ; i++){
+            stringsFit = validHandle(memberRecords[i].name);
+        }
+
+        // Every row must lie inside the ratings, after the one before it
+        bool rowsFit = rowStarts[0] == 0 && rowStarts[header->numMembers] == header->numRatings;
+        for(uint32_t i = 0 ; i<header->numMembers && rowsFit ; i++){
+            rowsFit = rowStarts[i] <= rowStarts[i + 1];
+        }
+        if(stringsFit && rowsFit){
+            return true;
+        }
+        error = filePath + (stringsFit ? " has a rating row out of order" : " has a broken string table");
+    }
+    close();
+    return false;
+}
+
+// Method to check that every string chunk holds whole string records, counting them
+bool Snapshot::checkChunks(uint64_t& strings) const{
+    strings = 0;
+    if(chunkTable[0] != 0 || chunkTable[header->numChunks] != header->stringBytes){
+        return false;
+    }
+    for(uint32_t c = 0 ; c<header->numChunks ; c++){
+        if(chunkTable[c + 1] < chunkTable[c] || chunkTable[c + 1] - chunkTable[c] > UINT32_MAX){
+            return false;
+        }
+
+        // A record is its length, its bytes and a null, and the records fill the chunk exactly
+        const char* chunk = base + header->stringOffset + chunkTable[c];
+        uint64_t size = chunkTable[c + 1] - chunkTable[c];
+        uint64_t at = 0;
+        while(at < size){
+            uint32_t n;
+            if(size - at < sizeof(n) + 1){
+                return false;
+            }
+            memcpy(&n, chunk + at, sizeof(n));
+            if(n > size - at - sizeof(n) - 1 || chunk[at + sizeof(n) + n] != '\0' ||
+               at >= STRING_CHUNK_BYTES){
+                return false;
+            }
+            at += sizeof(n) + n + 1;
+            strings++;
+        }
+    }
+    return true;
+}
+
+// Method to check that a handle points at a string record inside its chunk
+bool Snapshot::validHandle(uint32_t h) const{
+    uint32_t c = h >> STRING_CHUNK_BITS;
+    uint64_t at = h & (STRING_CHUNK_BYTES - 1);
+    if(c >= header->numChunks){
+        return false;
+    }
+    uint64_t size = chunkTable[c + 1] - chunkTable[c];
+    uint32_t n;
+    if(at + sizeof(n) + 1 > size){
+        return false;
+    }
+    memcpy(&n, base + header->stringOffset + chunkTable[c] + at, sizeof(n));
+    return n <= size - at - sizeof(n) - 1;
+}
+
+// Method to get a string of the snapshot, by handle if the pool adopted the chunks, else interned from
+// the mapping
+PooledString Snapshot::text(uint32_t h) const{
+    if(adopted){
+        return PooledString::fromHandle(h);
+    }
+    const char* record = base + header->stringOffset + chunkTable[h >> STRING_CHUNK_BITS] +
+                         (h & (STRING_CHUNK_BYTES - 1));
+    uint32_t n;
+    memcpy(&n, record, sizeof(n));
+    return PooledString(record + sizeof(n), n);
+}
+
+// Method to let the string pool use the snapshot's strings in place, returning false if the pool
+// already holds other strings (the snapshot must then stay open while the pool is used)
+bool Snapshot::adoptStrings(){
+    vector<const char*> starts(header->numChunks);
+    vector<uint32_t> sizes(header->numChunks);
+    for(uint32_t c = 0 ; c<header->numChunks ; c++){
+        starts[c] = base + header->stringOffset + chunkTable[c];
+        sizes[c] = (uint32_t)(chunkTable[c + 1] - chunkTable[c]);
+    }
+    adopted = stringPool().adopt(starts.data(), sizes.data(), starts.size(), header->numStrings);
+    return adopted;
+}
+
+// Method to unmap the file (the string pool must not have adopted its chunks)
+void Snapshot::close(){
+    file.close();
+    base = nullptr;
+    adopted = false;
+}
+
+// Function to round a size up to a multiple of 8
+static uint64_t aligned(uint64_t n){
+    return (n + 7) / 8 * 8;
+}
+
+// Method to write a snapshot of the first numBooks books, numMembers members and their ratings
+bool Snapshot::write(string filePath, const BookList& books, int numBooks, const MemberList& members, int numMembers,
+                     RatingList& ratings){
+
+    // The string chunks are the pool's own, so the records keep the handles they have in the lists
+    const StringPool& pool = stringPool();
+    vector<uint64_t> chunkStarts(pool.chunkCount() + 1, 0);
+    for(size_t c = 0 ; c<pool.chunkCount() ; c++){
+        chunkStarts[c + 1] = chunkStarts[c] + pool.chunkBytes(c);
+    }
+    vector<SnapshotBook> bookTable(numBooks);
+    vector<SnapshotMember> memberTable(numMembers);
+    for(int i = 0 ; i<numBooks ; i++){
+        Book b = books.getBook(i);
+        bookTable[i].author = b.Author.handle;
+        bookTable[i].title = b.Title.handle;
+        bookTable[i].year = b.Year;
+        bookTable[i].introducer = b.introducer;
+        bookTable[i].keyHash = books.keyHash(i);
+    }
+    for(int i = 0 ; i<numMembers ; i++){
+        Member m = members.getMember(i);
+        memberTable[i].name = m.Name.handle;
+        memberTable[i].addedBy = m.adddedBY;
+        memberTable[i].nameHash = members.nameHash(i);
+    }
+
+    // Only stored ratings are written, one sorted row per member
+    ratings.flushPending();
+    vector<uint64_t> rowStarts(numMembers + 1, 0);
+    vector<int32_t> ratingBooks;
+    vector<int8_t> ratingValues;
+    for(int i = 0 ; i<numMembers ; i++){
+        ratings.forEachRating(i, [&](int book, int rating){
+            if(book < numBooks){
+                ratingBooks.push_back(book);
+                ratingValues.push_back((int8_t)rating);
+            }
+        });
+        rowStarts[i + 1] = ratingBooks.size();
+    }
+
+    // Sections follow the header in file order, each starting on an 8-byte boundary
+    SnapshotHeader head;
+    memset(&head, 0, sizeof(head));
+    memcpy(head.magic, SNAPSHOT_MAGIC, sizeof(head.magic));
+    head.version = SNAPSHOT_VERSION;
+    head.numBooks = numBooks;
+    head.numMembers = numMembers;
+    head.numChunks = pool.chunkCount();
+    head.numStrings = pool.size();
+    head.numRatings = ratingBooks.size();
+    head.stringOffset = sizeof(SnapshotHeader);
+    head.stringBytes = chunkStarts.back();
+    head.chunkOffset = aligned(head.stringOffset + head.stringBytes);
+    head.bookOffset = head.chunkOffset + chunkStarts.size() * sizeof(uint64_t);
+    head.memberOffset = head.bookOffset + (uint64_t)numBooks * sizeof(SnapshotBook);
+    head.rowOffset = head.memberOffset + (uint64_t)numMembers * sizeof(SnapshotMember);
+    head.ratingBookOffset = head.rowOffset + rowStarts.size() * sizeof(uint64_t);
+    head.ratingValueOffset = aligned(head.ratingBookOffset + ratingBooks.size() * sizeof(int32_t));
+
+    string tempPath = filePath + ".tmp";
+    ofstream outputFile(tempPath, ios::binary);
+    if(!outputFile){
+        return false;
+    }
+    const char padding[8] = {0};
+    outputFile.write((const char*)&head, sizeof(head));
+    for(size_t c = 0 ; c<pool.chunkCount() ; c++){
+        outputFile.write(pool.chunkData(c), pool.chunkBytes(c));
+    }
+    outputFile.write(padding, head.chunkOffset - head.stringOffset - head.stringBytes);
+    outputFile.write((const char*)chunkStarts.data(), chunkStarts.size() * sizeof(uint64_t));
+    outputFile.write((const char*)bookTable.data(), bookTable.size() * sizeof(SnapshotBook));
+    outputFile.write((const char*)memberTable.data(), memberTable.size() * sizeof(SnapshotMember));
+    outputFile.write((const char*)rowStarts.data(), rowStarts.size() * sizeof(uint64_t));
+    outputFile.write((const char*)ratingBooks.data(), ratingBooks.size() * sizeof(int32_t));
+    outputFile.write(padding, head.ratingValueOffset - head.ratingBookOffset - ratingBooks.size() * sizeof(int32_t));
+    outputFile.write((const char*)ratingValues.data(), ratingValues.size());
+    outputFile.close();
+
+    // The snapshot, and its rename, must be on disk before true is returned, since the change log is
+    // emptied after it
+    if(!outputFile){
+        remove(tempPath.c_str());
+        return false;
+    }
+    return replaceFile(tempPath, filePath);
+}
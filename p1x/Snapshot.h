@@ -0,0 +1,179 @@
+//
+// Created by Shikha Pallavi on 10/16/26.
+//
+
+#ifndef P1X_SNAPSHOT_H
+#define P1X_SNAPSHOT_H
+
+// AUTHOR: Shikha Pallavi
+// PROGRAM: Snapshot.h
+// DATE: 10/16/2026
+// PURPOSE: Header file for a binary snapshot of the books, members and ratings that is read through mmap.
+// INPUT: None directly from the user. A snapshot is written from the session's lists and read from a file.
+// PROCESS: A snapshot file is laid out as
+//     header | string chunks | chunk table | book records | member records | rating rows
+// The header holds a magic tag, a format version, the counts and the offset of every section. The string
+// chunks are the string pool's chunks as they were, so records hold pool handles and a fresh pool adopts
+// the chunks in place instead of copying and hashing every string. Book and member records have a fixed
+// width, so book i is found by arithmetic, and carry the hash of their key so the lists' lookup tables are
+// filled without reading the strings. Ratings are stored as compressed sparse rows (a start offset per
+// member, then the book ids and the values of every rating), so the file grows with the number of
+// ratings, not with members x books, and the rows go into the rating list in one bulk call. Opening a
+// snapshot maps the file and checks the header, the section bounds, the string records and the row
+// offsets; nothing is parsed, and every read goes straight to the mapped pages.
+// OUTPUT: None directly. The snapshot hands out book and member fields and rating rows in place.
+
+#include<iostream>
+#include<string>
+#include<vector>
+#include<cstdint>
+#include "BookList.h"
+#include "MemberList.h"
+#include "RatingList.h"
+#include "MappedFile.h"
+
+// Tag at the start of every snapshot file, and the current format version
+#define SNAPSHOT_MAGIC "BOOKSNAP"
+#define SNAPSHOT_VERSION 2
+
+
+using namespace std;
+
+// Struct for the fixed header at the start of a snapshot file
+struct SnapshotHeader{
+
+    char magic[8];           // SNAPSHOT_MAGIC, not null terminated
+    uint32_t version;        // Format version
+    uint32_t numBooks;       // Number of book records
+    uint32_t numMembers;     // Number of member records
+    uint32_t numChunks;      // Number of string chunks
+    uint64_t numStrings;     // Number of strings in the chunks
+    uint64_t numRatings;     // Number of ratings in the rating rows
+    uint64_t stringOffset;   // File offset of the string chunks
+    uint64_t stringBytes;    // Size of the string chunks
+    uint64_t chunkOffset;    // File offset of the chunk table (numChunks + 1 offsets into the string chunks)
+    uint64_t bookOffset;     // File offset of the book records
+    uint64_t memberOffset;   // File offset of the member records
+    uint64_t rowOffset;      // File offset of the row starts (numMembers + 1 offsets into the ratings)
+    uint64_t ratingBookOffset;   // File offset of the book id of every rating
+    uint64_t ratingValueOffset;  // File offset of the value of every rating
+
+};
+
+// Struct for one book record of a snapshot
+struct SnapshotBook{
+
+    uint32_t author;         // Author's handle in the string chunks
+    uint32_t title;          // Title's handle in the string chunks
+    int32_t year;            // Year of publication
+    int32_t introducer;      // ID of the user who introduced the book
+    uint64_t keyHash;        // Hash of the book's key, as the book list computes it
+
+};
+
+// Struct for one member record of a snapshot
+struct SnapshotMember{
+
+    uint32_t name;           // Name's handle in the string chunks
+    int32_t addedBy;         // ID of the user who added the member
+    uint64_t nameHash;       // Hash of the name, as the member list computes it
+
+};
+
+// Class for reading a snapshot file in place through mmap
+class Snapshot{
+private:
+
+    MappedFile file;                 // Mapping of the snapshot file
+    const char* base;                // Start of the mapped file, or null when nothing is open
+    const SnapshotHeader* header;    // Header at the start of the file
+    const uint64_t* chunkTable;      // Offset of every string chunk, plus the end of the last one
+    const SnapshotBook* bookRecords;      // Book records inside the mapping
+    const SnapshotMember* memberRecords;  // Member records inside the mapping
+    const uint64_t* rowStarts;       // Start of every member's ratings, plus the end of the last row
+    const int32_t* ratingBooks;      // Book id of every rating
+    const int8_t* ratingValues;      // Value of every rating
+    bool adopted;                    // True once the string pool uses the chunks in place
+
+    // Method to check that every string chunk holds whole string records, counting them
+    bool checkChunks(uint64_t& strings) const;
+
+    // Method to check that a handle points at a string record inside its chunk
+    bool validHandle(uint32_t h) const;
+
+    // Method to get a string of the snapshot, by handle if the pool adopted the chunks, else interned from
+    // the mapping
+    PooledString text(uint32_t h) const;
+
+public:
+
+    // Constructor to create a snapshot with nothing open
+    Snapshot(){
+        base = nullptr;
+        adopted = false;
+    }
+
+    // Method to map a snapshot file and check its header, returning false (with a reason) if it cannot be used
+    bool open(string filePath, string& error);
+
+    // Method to unmap the file (the string pool must not have adopted its chunks)
+    void close();
+
+    // Method to let the string pool use the snapshot's strings in place, returning false if the pool
+    // already holds other strings (the snapshot must then stay open while the pool is used)
+    bool adoptStrings();
+
+    // Method to get the number of books
+    int getNumBooks() const{
+        return header->numBooks;
+    }
+
+    // Method to get the number of members
+    int getNumMembers() const{
+        return header->numMembers;
+    }
+
+    // Method to get a book, with its ISBN (index + 1) filled in
+    Book book(int i) const{
+        const SnapshotBook& b = bookRecords[i];
+        return Book(i + 1, text(b.author), text(b.title), b.year, b.introducer);
+    }
+
+    // Method to get the hash of a book's key
+    uint64_t bookKeyHash(int i) const{
+        return bookRecords[i].keyHash;
+    }
+
+    // Method to get a member, with its account number (index + 1) filled in
+    Member member(int i) const{
+        const SnapshotMember& m = memberRecords[i];
+        return Member(text(m.name), i + 1, m.addedBy);
+    }
+
+    // Method to get the hash of a member's name
+    uint64_t memberNameHash(int i) const{
+        return memberRecords[i].nameHash;
+    }
+
+    // Method to get the start of every member's ratings, plus the end of the last row
+    const uint64_t* getRowStarts() const{
+        return rowStarts;
+    }
+
+    // Method to get the book id of every rating
+    const int32_t* getRatingBooks() const{
+        return ratingBooks;
+    }
+
+    // Method to get the value of every rating
+    const int8_t* getRatingValues() const{
+        return ratingValues;
+    }
+
+    // Method to write a snapshot of the first numBooks books, numMembers members and their ratings
+    static bool write(string filePath, const BookList& books, int numBooks, const MemberList& members, int numMembers,
+                      RatingList& ratings);
+
+};
+
+#endif //P1X_SNAPSHOT_H
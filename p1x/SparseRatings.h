@@ -0,0 +1,98 @@
+//
+// Created by Shikha Pallavi on 10/16/26.
+//
+
+#ifndef P1X_SPARSERATINGS_H
+#define P1X_SPARSERATINGS_H
+
+// AUTHOR: Shikha Pallavi
+// PROGRAM: SparseRatings.h
+// DATE: 10/16/2026
+// PURPOSE: Header file for a sparse rating store used by RatingList when the catalog is large and mostly unrated.
+// INPUT: None directly from the user. Ratings are added through set() by RatingList.
+// PROCESS: Ratings are kept in compressed sparse row (CSR) form: for every member a sorted run of
+// (book, rating) pairs. New ratings go into a small delta buffer first and are merged into the rows
+// in batches, so adding a rating does not shift the whole CSR arrays.
+// OUTPUT: None directly. The store answers single rating lookups and dot products between two members.
+
+#include<iostream>
+#include<string>
+#include<vector>
+#include<unordered_map>
+#include<cstdint>
+
+// Smallest number of buffered ratings that triggers a merge into the CSR rows
+#define SPARSE_MIN_MERGE 4096
+
+
+using namespace std;
+
+// Class for storing ratings as sorted (book, rating) rows per member
+class SparseRatings{
+private:
+
+    vector<int> rowStart;      // CSR row offsets, one entry per member plus one
+    vector<int> bookIds;       // Book id of every stored rating, sorted within each row
+    vector<int8_t> values;     // Rating of every stored entry
+    unordered_map<long long, int8_t> pending;  // Delta buffer of ratings not merged yet (0 removes)
+    int members;               // Number of member rows
+
+    // Method to build the key of a (member, book) cell in the delta buffer
+    static long long cellKey(int member, int book){
+        return ((long long)member << 32) | (unsigned int)book;
+    }
+
+public:
+
+    // Constructor to create an empty store with the given number of member rows
+    SparseRatings(int m){
+        members = m;
+        rowStart.assign(members + 1, 0);
+    }
+
+    // Method to add empty rows until the store has m members
+    void growMembers(int m);
+
+    // Method to get the rating of a member for a book (0 if unrated)
+    int get(int member, int book) const;
+
+    // Method to set the rating of a member for a book, buffering it until the next merge
+    void set(int member, int book, int rating);
+
+    // Method to merge the delta buffer into the CSR rows
+    void merge();
+
+    // Method to add whole rows at once: member first + i rated bookIds[k] with values[k] for k in
+    // [rowStart[i], rowStart[i + 1]). Works only if the members from first on have no merged ratings yet
+    // (returning false, with nothing stored, otherwise); rows sorted by book, with every book below
+    // bookLimit and every value non-zero, go straight to the end of the CSR arrays, and the cells of any
+    // other row (those below bookLimit) go through the delta buffer.
+    bool appendRows(int first, int count, const uint64_t* rowStart, const int32_t* bookIds, const int8_t* values,
+                    int bookLimit);
+
+    // Method to check whether the delta buffer holds ratings not yet merged
+    bool hasPending() const{
+        return !pending.empty();
+    }
+
+    // Method to get the number of rated books of a member (rows must be merged)
+    int rowLength(int member) const{
+        return rowStart[member + 1] - rowStart[member];
+    }
+
+    // Method to get the sorted book ids of a member's row (rows must be merged)
+    const int* rowBooks(int member) const{
+        return bookIds.data() + rowStart[member];
+    }
+
+    // Method to get the ratings of a member's row (rows must be merged)
+    const int8_t* rowValues(int member) const{
+        return values.data() + rowStart[member];
+    }
+
+    // Method to compute the sum of rating products over the books both members rated (rows must be merged)
+    int dot(int a, int b) const;
+
+};
+
+#endif //P1X_SPARSERATINGS_H
@@ -0,0 +1,66 @@
+//
+// Created by Shikha Pallavi on 10/16/26.
+//
+
+#ifndef P1X_THREADPOOL_H
+#define P1X_THREADPOOL_H
+
+// AUTHOR: Shikha Pallavi
+// PROGRAM: ThreadPool.h
+// DATE: 10/16/2026
+// PURPOSE: Header file for a small reusable thread pool that runs one job split into numbered parts.
+// INPUT: None directly from the user. The number of threads is given when the pool is created.
+// PROCESS: The worker threads are started once and sleep between jobs. run() hands out the parts of a
+// job one at a time to the workers and to the calling thread, then waits until every part is done.
+// OUTPUT: None directly. Each part writes its own results through the job it runs.
+
+#include<iostream>
+#include<string>
+#include<vector>
+#include<thread>
+#include<mutex>
+#include<condition_variable>
+#include<functional>
+
+
+using namespace std;
+
+// Class for running the parts of a job on a fixed set of threads
+class ThreadPool{
+private:
+
+    vector<thread> workers;          // Worker threads (the caller of run() is the last thread)
+    mutex lock;                      // Guards every field below
+    condition_variable wake;         // Signals workers that a job is ready or the pool is stopping
+    condition_variable finished;     // Signals run() that the last part of the job is done
+    const function<void(int)>* job;  // Job being run, or null between jobs
+    int parts;                       // Number of parts of the current job
+    int nextPart;                    // Next part to hand out
+    int doneParts;                   // Number of parts finished
+    bool stopping;                   // Set when the pool is being destroyed
+
+    // Method to take parts of the current job until none are left
+    void work(unique_lock<mutex>& held);
+
+    // Method run by every worker thread
+    void workerLoop();
+
+public:
+
+    // Constructor to start the pool; threads <= 0 uses every hardware thread
+    ThreadPool(int threads);
+
+    // Destructor to stop and join the worker threads
+    ~ThreadPool();
+
+    // Method to get the number of threads that run parts, the caller included
+    int size() const{
+        return (int)workers.size() + 1;
+    }
+
+    // Method to run task(0) .. task(count-1) across the pool and wait for all of them
+    void run(int count, const function<void(int)>& task);
+
+};
+
+#endif //P1X_THREADPOOL_H
@@ -3,10 +3,15 @@
 // PURPOSE: Implementation of a book recommendation system.
 //          This program allows users to add members, books, and ratings,
 //          login/logout, view and rate books, and receive book recommendations.
-// INPUT:   File paths to input files containing information about books and ratings.
+// INPUT:   File paths to input files containing information about books and ratings, or the binary
+//          snapshot written by the last run. "p1x --convert books ratings snapshot" converts text files,
+//          and "p1x --merge books ratings" merges another catalog into the library.
 // PROCESS: The program reads data from input files to populate member, book, and rating records.
 //          Users can perform various actions through a menu-driven interface, including adding members/books,
-//          logging in, rating books, viewing ratings, and receiving recommendations based on their preferences.
+//          logging in, rating books, searching titles and authors, viewing ratings, and receiving recommendations
+//          based on their preferences.
+//          Every change is appended to a log that is replayed on top of the snapshot at the next start.
+//          The text files are saved at quit, rewriting only the rating rows that changed.
 // OUTPUT:  Display messages indicating successful operations, error messages for invalid input or operations,
 //          and recommendations for books based on user preferences
 
@@ -16,11 +21,31 @@
 #include "BookList.h"
 #include "MemberList.h"
 #include "RatingList.h"
+#include "RatingFileReader.h"
+#include "ItemSimilarity.h"
+#include "Snapshot.h"
+#include "EventLog.h"
+#include "RatingsFile.h"
+#include "BookSearch.h"
 #include<sstream>
 #include<fstream>
+#include<sys/stat.h>
 
 #define INITIAL_MEM_CAP 100
 #define INITIAL_BOOK_CAP	100
+#define TOP_NEIGHBOURS	10	// Number of similar members whose ratings feed the top picks
+#define RECOMMEND_THREADS	0	// Threads shared by the similar-member search, the ratings load and the model and index builds (0 = all hardware threads)
+#define SEARCH_RESULTS	10	// Books shown for a search
+#define LSH_TABLES	0	// Hash tables of the approximate neighbour search (0 = exact search)
+#define SIMILARITY_CACHE	(LSH_TABLES == 0)	// Keep member similarities up to date on every rating, unless the approximate search is on
+#define LSH_BITS	LSH_DEFAULT_BITS	// Signature bits per hash table
+#define LSH_RECALL_SAMPLES	200	// Members sampled to report the approximate search's recall@1
+#define ITEM_MODEL_FILE	"item-similarity.txt"	// File the book-to-book model is kept in between runs, next to the ratings
+#define SNAPSHOT_FILE	"library.snap"	// Binary snapshot read at start instead of the text files when present
+#define EVENT_LOG_FILE	"library.log"	// Changes made since the snapshot was written
+#define BOOK_TEXT_FILE	"books-updated.txt"	// Books written as text at every checkpoint and at quit
+#define RATING_TEXT_FILE	"ratings-updated.txt"	// Ratings written as text at every checkpoint and at quit
+#define LOG_COMPACT_BYTES	(16 * 1024 * 1024)	// Log size at which it is folded into a new snapshot
 
 
 using namespace std;
@@ -33,6 +58,11 @@ struct Session{
     MemberList* memRecord;  // Pointer to the member list
     BookList* bookRecord;   // Pointer to the book list
     RatingList* ratings;    // Pointer to the rating list
+    ItemSimilarity* itemModel = nullptr; // Pointer to the book-to-book model, once the files are read
+    BookSearch* search = nullptr;   // Title and author search index, once the files are read
+    EventLog* eventLog = nullptr;   // Log every change is appended to, once the files are read
+    RatingsFile ratingsFile;        // Saver that rewrites only the changed rows of the ratings file
+    ScratchArena scratch;           // Arrays of the current recommendation, reused by the next one
     int totalMembers = 0;   // Total number of members
     int totalBooks = 0;     // Total number of books
     int capacityMembers;    // Capacity of the member list
@@ -46,6 +76,9 @@ struct Session{
         memRecord = new MemberList(INITIAL_MEM_CAP);
         bookRecord = new BookList(INITIAL_BOOK_CAP);
         ratings = new RatingList(INITIAL_MEM_CAP,INITIAL_BOOK_CAP);
+        ratings->setThreadCount(RECOMMEND_THREADS);
+        ratings->setSimilarityCache(SIMILARITY_CACHE);
+        ratings->setApproximateSearch(LSH_TABLES, LSH_BITS);
         capacityMembers = INITIAL_MEM_CAP;
         capacityBooks = INITIAL_BOOK_CAP;
 
@@ -53,17 +86,27 @@ struct Session{
 
     // Getter method to retrieve the rating for a given member and book
     int getRating(int member, int isbn ){
-        return (ratings->getRatingMap())[member][isbn];
+        return ratings->getRating(member, isbn);
     }
 
     // Getter method to retrieve the profile of the currently logged-in user
     Member myProfile(){
-        return (memRecord->getMemberArray())[loggedInUser];
+        return memRecord->getMember(loggedInUser);
     }
 
     // Getter method to retrieve details of a book based on ISBN
     Book bookDetail(int isbn){
-        return (bookRecord->getBookArray())[isbn];
+        return bookRecord->getBook(isbn);
+    }
+
+    // Getter method to find a book with the same author, title and year, returning its index or -1
+    int findBook(PooledString Author, PooledString Title, int Year){
+        return bookRecord->findBook(Author, Title, Year);
+    }
+
+    // Getter method to retrieve the IDs of every member with a name, in account order
+    void findMembers(string name, vector<int>& accounts){
+        memRecord->findMembers(name.data(), name.size(), accounts);
     }
 
     // Getter method to retrieve the ID of the currently logged-in user
@@ -128,8 +171,19 @@ struct Session{
         }
     }
 
+    // Method to make room for numMembers members and numBooks books before a bulk load
+    void reserve(int numMembers, int numBooks){
+
+        // A list is grown once it is full, so keep one slot more than will be used
+        capacityMembers = max(capacityMembers, numMembers + 1);
+        capacityBooks = max(capacityBooks, numBooks + 1);
+        memRecord->reserve(capacityMembers);
+        bookRecord->reserve(capacityBooks);
+        ratings->reserve(capacityMembers, capacityBooks);
+    }
+
     // Method to add a new member to the system
-    void addMember(string name){
+    void addMember(PooledString name){
 
         memRecord->addMember(name,loggedInUser);
         totalMembers++;
@@ -137,11 +191,14 @@ struct Session{
             ratings->resizeMembers();
             capacityMembers = 2*capacityMembers;
         }
+        if(eventLog){
+            eventLog->addMember(totalMembers-1, name.str(), loggedInUser);
+        }
 
     }
 
     // Method to add a new book to the system
-    void addBook(string Author, string Title, int Year){
+    void addBook(PooledString Author, PooledString Title, int Year){
 
         bookRecord->addBook(Author, Title, Year, loggedInUser);
         totalBooks++;
@@ -149,6 +206,12 @@ struct Session{
             ratings->resizeBooks();
             capacityBooks = 2*capacityBooks;
         }
+        if(eventLog){
+            eventLog->addBook(totalBooks-1, Author.str(), Title.str(), Year, loggedInUser);
+        }
+        if(search){
+            search->addBook(totalBooks-1, bookRecord->getBook(totalBooks-1));
+        }
 
     }
 
@@ -169,55 +232,138 @@ struct Session{
             cout<<"Book with ISBN no. ";
             cout<<book<<"does not exist in the database. \n";
         }
+        if(rating < -RATING_LIMIT || rating > RATING_LIMIT){
+            cout<<"Rating "<<rating<<" is out of range ("<<-RATING_LIMIT<<" to "<<RATING_LIMIT<<").\n";
+            return;
+        }
+
+
+        ratings->setRating(member, book, rating);
+        if(itemModel){
+            itemModel->ratingChanged(*ratings, member, book);
+        }
+        if(eventLog && member < totalMembers && book < totalBooks){
+            eventLog->addRating(member, book, rating);
+        }
+    }
+
+    // Method to add the members of a parsed chunk of a ratings file with their ratings in one bulk step,
+    // rating column j going to book columns[j]
+    void addRatedMembers(RatingChunk& chunk, const vector<int>& columns){
+
+        int first = totalMembers;
+        int n = (int)chunk.names.size();
+        memRecord->addMembers(n, [&](int i){
+            return Member(PooledString(chunk.names[i], chunk.nameLengths[i]), first + i + 1, loggedInUser);
+        });
+        totalMembers += n;
+        while(totalMembers >= capacityMembers){
+            ratings->resizeMembers();
+            capacityMembers = 2*capacityMembers;
+        }
+
+        // The rows are handed to the rating list whole once their columns are turned into books
+        for(int32_t& book : chunk.bookIds){
+            book = columns[book];
+        }
+        ratings->addRows(first, n, chunk.rowStart.data(), chunk.bookIds.data(), chunk.values.data());
 
+        // Bulk loads run before the log and the item model exist, but anything added later is still passed on
+        if(eventLog || itemModel){
+            for(int i = 0 ; i<n ; i++){
+                if(eventLog){
+                    eventLog->addMember(first + i, memRecord->getMember(first + i).Name.str(), loggedInUser);
+                }
+                for(uint64_t k = chunk.rowStart[i] ; k<chunk.rowStart[i + 1] ; k++){
+                    if(itemModel){
+                        itemModel->ratingChanged(*ratings, first + i, chunk.bookIds[k]);
+                    }
+                    if(eventLog){
+                        eventLog->addRating(first + i, chunk.bookIds[k], chunk.values[k]);
+                    }
+                }
+            }
+        }
+    }
+
+    // Method to load the book-to-book model saved by the last run, or build it if it is out of date
+    void loadItemModel(string filePath){
+        itemModel = new ItemSimilarity(ITEM_NEIGHBOURS);
+        if(!itemModel->load(filePath, totalBooks, ratings->checksum())){
+            itemModel->build(*ratings, totalBooks);
+        }
+    }
 
-        (ratings->getRatingMap())[member][book] = rating;
+    // Method to build the title and author search index over every book
+    void buildSearchIndex(){
+        search = new BookSearch();
+        search->build(*bookRecord, totalBooks, ratings->getPool());
+    }
+
+    // Method to show up to n books whose title or author match the words of a query
+    void searchBooks(string query, int n){
+        vector<BookScore> found = search->search(query, n);
+        if(found.empty()){
+            cout<<"No books match \""<<query<<"\".\n\n";
+            return;
+        }
+        cout<<"Books matching \""<<query<<"\": \n";
+        for(size_t i = 0 ; i<found.size() ; i++){
+            Book b = bookRecord->getBook(found[i].book);
+            cout<< b.ISBN <<", "<< b.Author << ", ";
+            cout<< b.Title << ", " << b.Year <<"\n";
+        }
+        cout<<"\n\n";
+    }
+
+    // Method to save the book-to-book model for the next run
+    void saveItemModel(string filePath){
+        if(itemModel){
+            itemModel->refresh(*ratings);
+            itemModel->save(filePath, ratings->checksum());
+        }
     }
 
     // Method to get recommendations for books based on user preferences
     void getRecomendations(){
-        int** similarity;
-        similarity = ratings->recomendBook(loggedInUser);
+        // The result lives in the scratch arena until the next request
+        scratch.reset();
+        Recommendation similarity = ratings->recomendBook(loggedInUser, scratch);
 
-        int* detail = 	similarity[0];
-        int* books = similarity[1];
-        int similarUser = detail[0];
-        int count = detail[1];
+        const int* books = similarity.books;
+        int similarUser = similarity.similarUser;
+        int count = similarity.count;
         int firstLimit = -1;
         int secondLimit = -1;
         cout<<"You have similar taste in books as ";
-        cout<< ((memRecord->getMemberArray())[similarUser]).Name;
+        cout<< memRecord->getName(similarUser);
         cout<<" !\n\n";
 
-        int* bestbooks = new int[count];
-        int* secondBestBooks =new  int[count];
         for(int i = 0 ; i<count ; i++){
-            int rating1 = (ratings->getRatingMap())[similarUser][books[i]];
-            int rating2 = (ratings->getRatingMap())[similarUser][books[i-1]];
+            int rating1 = ratings->getRating(similarUser, books[i]);
+            int rating2 = (i>0) ? ratings->getRating(similarUser, books[i-1]) : rating1;
             if(i>0 && rating1 != rating2){
 
                 break;
 
             }
-            bestbooks[i] = books[i];
             firstLimit = i;
 
         }
 
 
         for(int i = firstLimit+1 ; i<count && firstLimit+1 > 0  ; i++){
-            int rating1 = (ratings->getRatingMap())[similarUser][books[i]];
-            int rating2 = (ratings->getRatingMap())[similarUser][books[i-1]];
+            int rating1 = ratings->getRating(similarUser, books[i]);
+            int rating2 = ratings->getRating(similarUser, books[i-1]);
             if(i>0 && (i != firstLimit+1) && rating1 != rating2){
                 break;
             }
-            secondBestBooks[i] = books[i];
             secondLimit = i;
         }
 
         cout<<"Here are the books they really liked: \n";
         for(int i = firstLimit ; i>=0 ; i--){
-            Book b = (bookRecord->getBookArray())[bestbooks[i]];
+            Book b = bookRecord->getBook(books[i]);
             cout<< b.ISBN <<", "<< b.Author << ", ";
             cout<< b.Title << ", " << b.Year <<"\n";
 
@@ -226,7 +372,7 @@ struct Session{
         cout<<"And here are the books they liked: \n";
 
         for(int i = secondLimit ; i>firstLimit ; i--){
-            Book b = (bookRecord->getBookArray())[secondBestBooks[i]];
+            Book b = bookRecord->getBook(books[i]);
             cout<< b.ISBN <<", "<< b.Author << ", " ;
             cout<< b.Title << ", " << b.Year <<"\n";
         }
@@ -239,27 +385,148 @@ struct Session{
     }
 
 
+    // Method to show the n best books for the current user, scored over the k most similar members
+    void getTopRecomendations(int k, int n){
+        vector<BookScore> picks = ratings->recommendTopBooks(loggedInUser, k, n);
+        if(picks.empty()){
+            cout<<"No top picks yet, rate a few more books first.\n\n";
+            return;
+        }
+        cout<<"Top picks from the members with the most similar taste: \n";
+        for(size_t i = 0 ; i<picks.size() ; i++){
+            Book b = bookRecord->getBook(picks[i].book);
+            cout<< b.ISBN <<", "<< b.Author << ", ";
+            cout<< b.Title << ", " << b.Year <<"\n";
+        }
+        cout<<"\n\n";
+    }
+
+    // Method to show the n books most similar to the ones the current user rated
+    void getSimilarBookRecomendations(int n){
+        vector<BookScore> picks = itemModel->recommend(*ratings, loggedInUser, n);
+        if(picks.empty()){
+            cout<<"No similar books yet, rate a few more books first.\n\n";
+            return;
+        }
+        cout<<"Books similar to the ones you rated: \n";
+        for(size_t i = 0 ; i<picks.size() ; i++){
+            Book b = bookRecord->getBook(picks[i].book);
+            cout<< b.ISBN <<", "<< b.Author << ", ";
+            cout<< b.Title << ", " << b.Year <<"\n";
+        }
+        cout<<"\n\n";
+    }
+
+    // Method to load books, members and ratings from a mapped snapshot
+    void loadSnapshot(Snapshot& snap){
+
+        // Rebuilding the similarity cache once at the end is cheaper than updating it per rating
+        ratings->setSimilarityCache(false);
+        reserve(snap.getNumMembers(), snap.getNumBooks());
+
+        // The strings are used where they lie in the mapping, and the lists take the stored key hashes
+        snap.adoptStrings();
+        bookRecord->addBooks(snap.getNumBooks(), [&](int i){ return snap.book(i); },
+                             [&](int i){ return snap.bookKeyHash(i); });
+        totalBooks += snap.getNumBooks();
+        memRecord->addMembers(snap.getNumMembers(), [&](int i){ return snap.member(i); },
+                              [&](int i){ return snap.memberNameHash(i); });
+        totalMembers += snap.getNumMembers();
+
+        // The rating rows go in with one bulk call
+        ratings->addRows(0, snap.getNumMembers(), snap.getRowStarts(), snap.getRatingBooks(), snap.getRatingValues());
+        ratings->setSimilarityCache(SIMILARITY_CACHE);
+    }
+
+    // Method to write books, members and ratings to a snapshot file
+    bool writeSnapshot(string filePath){
+        return Snapshot::write(filePath, *bookRecord, totalBooks, *memRecord, totalMembers, *ratings);
+    }
+
+    // Method to apply the changes of a log on top of what was loaded, returning the number applied
+    int replayLog(EventLog& log){
+        int applied = 0;
+        bool consistent = true;
+        ratings->setSimilarityCache(false);
+        log.replay([&](const LogEvent& e){
+
+            // Members and books already loaded were logged before the snapshot was written
+            if(!consistent){
+                return;
+            }
+            if(e.type == EVENT_MEMBER){
+                if(e.index < totalMembers) return;
+                consistent = e.index == totalMembers;
+                if(!consistent) return;
+                addMember(e.name);
+                memRecord->setMember(totalMembers-1, Member(e.name, totalMembers, e.addedBy));
+            }
+            else if(e.type == EVENT_BOOK){
+                if(e.index < totalBooks) return;
+                consistent = e.index == totalBooks;
+                if(!consistent) return;
+                addBook(e.name, e.title, e.year);
+                bookRecord->setBook(totalBooks-1, Book(totalBooks, e.name, e.title, e.year, e.addedBy));
+            }
+            else{
+                if(e.index >= totalMembers || e.book >= totalBooks) return;
+                ratings->setRating(e.index, e.book, e.rating);
+            }
+            applied++;
+        });
+        ratings->setSimilarityCache(SIMILARITY_CACHE);
+        if(!consistent){
+            cout<<"Ignoring the rest of "<<EVENT_LOG_FILE<<": it does not follow the loaded data.\n";
+        }
+        return applied;
+    }
+
+    // Method to fold the log into a new snapshot and empty it; the log is only emptied once the snapshot
+    // and its rename are on disk, so a crash leaves either the old snapshot with the full log or the new one
+    void checkpoint(){
+        if(!writeSnapshot(SNAPSHOT_FILE)){
+            cout<<"Error writing snapshot file "<<SNAPSHOT_FILE<<".\n";
+            return;
+        }
+        saveTextFiles();
+        if(eventLog){
+            eventLog->reset();
+        }
+    }
+
+    // Method to commit the logged changes, folding them into a new snapshot once the log is large
+    void commitLog(){
+        if(eventLog == nullptr){
+            return;
+        }
+        eventLog->commit();
+        if(eventLog->size() > LOG_COMPACT_BYTES){
+            checkpoint();
+        }
+    }
+
     // Method to write book data to a file
     void writeBookFile(string filePath){
         ofstream outputFile(filePath);
         for(int i = 0 ; i<totalBooks ; i++){
-            Book b = (bookRecord->getBookArray())[i];
+            Book b = bookRecord->getBook(i);
             outputFile<<b.Author<<","<<b.Title<<","<<b.Year<<"\n";
         }
         outputFile.close();
     }
 
-    // Method to write rating data to a file
+    // Method to write rating data to a file, rewriting only the rows changed since the last save when it can
     void writeRatingsFile(string filePath){
-        ofstream outputFile(filePath);
-        for(int i = 0 ; i<totalMembers ; i++){
-            outputFile<<(memRecord->getMemberArray())[i].Name<<"\n";
-            for(int j = 0 ; j<totalBooks ; j++){
-                outputFile<<(ratings->getRatingMap())[i][j]<<" ";
-            }
-            outputFile<<"\n";
+        long long rows = ratingsFile.save(filePath, *memRecord, totalMembers, totalBooks, *ratings);
+        if(rows < 0){
+            cout<<"Error writing rating file "<<filePath<<".\n";
         }
-        outputFile.close();
+    }
+
+    // Method to write the book and rating text files
+    void saveTextFiles(){
+        writeBookFile(BOOK_TEXT_FILE);
+        writeRatingsFile(RATING_TEXT_FILE);
     }
 
 
@@ -300,17 +567,55 @@ void PromtaddMember(Session* s){
 
 }
 
-// Function to prompt the user to log in
+// Function to read a member account given as its number or as the member's name, returning the account
+// number (0 if no single member has the name)
+int readAccount(Session* s){
+
+    // Names may hold spaces, so the entry is the rest of the line, without the spaces around it
+    string entry;
+    cin>>ws;
+    getline(cin, entry);
+    entry.erase(entry.find_last_not_of(" \t\r") + 1);
+
+    // A number is an account if that account exists; anything else, and a number with no account
+    // behind it, is looked up as a name (so members whose names are digits can still log in by name)
+    bool digits = !entry.empty() && entry.find_first_not_of("0123456789") == string::npos;
+    if(digits && entry.size() <= 9 && stoi(entry) >= 1 && stoi(entry) <= s->getNumMembers()){
+        return stoi(entry);
+    }
+    vector<int> accounts;
+    s->findMembers(entry, accounts);
+    if(accounts.empty()){
+        if(digits){
+            cout<<"No member has account "<<entry<<" or is called "<<entry<<".\n";
+        }
+        else{
+            cout<<"No member is called "<<entry<<".\n";
+        }
+        return 0;
+    }
+    if(accounts.size() > 1){
+        cout<<"Several members are called "<<entry<<": accounts";
+        for(size_t i = 0 ; i<accounts.size() ; i++){
+            cout<<(i>0 ? ", " : " ")<<accounts[i]+1;
+        }
+        cout<<".\n";
+        return 0;
+    }
+    return accounts[0]+1;
+}
+
+// Function to prompt the user to log in, by account number or by name
 void PromtlogIN(Session* s){
     int mem;
-    cout<<"Enter member account: ";
-    cin>>mem;
+    cout<<"Enter member account or name: ";
+    mem = readAccount(s);
 
     while(mem <= 0){
         cout<<"\n";
-        cout<<"Please enter a valid account number (>0)\n";
-        cout<<"Enter member account: ";
-        cin>>mem;
+        cout<<"Please enter a valid account number (1 to "<<s->getNumMembers()<<") or member name\n";
+        cout<<"Enter member account or name: ";
+        mem = readAccount(s);
     }
 
     // cout<<"\n";
@@ -318,6 +623,19 @@ void PromtlogIN(Session* s){
     cout<<(s->myProfile()).Name<<", you are logged in!\n\n";
 }
 
+// Function to read a rating, asking again until it fits the rating map
+int readRating(){
+    int rating;
+    cout<<"Enter your rating: ";
+    cin>>rating;
+    while(rating < -RATING_LIMIT || rating > RATING_LIMIT){
+        cout<<"Please enter a rating between "<<-RATING_LIMIT<<" and "<<RATING_LIMIT<<"\n";
+        cout<<"Enter your rating: ";
+        cin>>rating;
+    }
+    return rating;
+}
+
 // Function to prompt the user to rate a book
 void Promtrate(Session* s){
     int ISBN,rating;
@@ -335,8 +653,7 @@ void Promtrate(Session* s){
         cin>>verdict;
         // cout<<"\n";
         if(verdict[0]=='y'){
-            cout<<"Enter your rating: ";
-            cin>>rating;
+            rating = readRating();
             cout<<"\n";
             s->addRating(s->currentUser(), ISBN-1, rating);
             cout<<"Your new rating for ";
@@ -347,8 +664,7 @@ void Promtrate(Session* s){
         }
     }
     else{
-        cout<<"Enter your rating: ";
-        cin>>rating;
+        rating = readRating();
         // cout<<"\n";
         s->addRating(s->currentUser(), ISBN-1, rating);
         cout<<"Your new rating for ";
@@ -359,6 +675,34 @@ void Promtrate(Session* s){
     }
 }
 
+// Function to prompt the user for how many top picks to show
+void PromttopPicks(Session* s){
+    int count;
+    cout<<"How many books would you like to see? ";
+    cin>>count;
+    cout<<"\n";
+    s->getTopRecomendations(TOP_NEIGHBOURS, count);
+}
+
+// Function to prompt the user for how many similar-book picks to show
+void PromtsimilarBooks(Session* s){
+    int count;
+    cout<<"How many books would you like to see? ";
+    cin>>count;
+    cout<<"\n";
+    s->getSimilarBookRecomendations(count);
+}
+
+// Function to prompt the user for words to search the titles and authors for
+void PromtsearchBooks(Session* s){
+    string query;
+    cin.ignore();
+    cout<<"Enter words from the title or author: ";
+    getline(cin,query);
+    cout<<"\n";
+    s->searchBooks(query, SEARCH_RESULTS);
+}
+
 // Function to print ratings for books
 void printRatings(Session* s){
     int numBooks = s->getNumBooks();
@@ -394,7 +738,10 @@ int showLogInMenu(){
     cout<<" 3. Rate book                   *\n*";
     cout<<" 4. View ratings                *\n*";
     cout<<" 5. See recommendations         *\n*";
-    cout<<" 6. Logout                      *\n";
+    cout<<" 6. Logout                      *\n*";
+    cout<<" 7. See top picks               *\n*";
+    cout<<" 8. See similar books           *\n*";
+    cout<<" 9. Search books                *\n";
     cout<<"**********************************\n\n";
     cout<<"Enter a menu option: ";
     cin>>option;
@@ -402,8 +749,41 @@ int showLogInMenu(){
     return option;
 }
 
-// Function to read book data from a file and add it to the system
-int readBookFile(Session* s, string bookFile ){
+// Function to check whether a file is missing or was last modified before another one
+bool modifiedBefore(string filePath, string otherPath){
+    struct stat file, other;
+    if(stat(filePath.c_str(), &file) != 0 || stat(otherPath.c_str(), &other) != 0){
+        return true;
+    }
+    if(file.st_mtim.tv_sec != other.st_mtim.tv_sec){
+        return file.st_mtim.tv_sec < other.st_mtim.tv_sec;
+    }
+    return file.st_mtim.tv_nsec < other.st_mtim.tv_nsec;
+}
+
+// Function to get the path of a file kept in the same directory as another file
+string besideFile(string otherPath, string fileName){
+    size_t slash = otherPath.find_last_of('/');
+    if(slash == string::npos){
+        return fileName;
+    }
+    return otherPath.substr(0, slash + 1) + fileName;
+}
+
+// Function to size a session for the books and members in the given files before reading them
+void presizeSession(Session* s, string bookFile, string ratingFile){
+    MappedFile books, ratings;
+    string error;
+
+    // One book per line; a member takes a name line and a ratings line
+    long long numBooks = books.open(bookFile, error) ? books.countLines() : 0;
+    long long numMembers = ratings.open(ratingFile, error) ? (ratings.countLines() + 1)/2 : 0;
+    s->reserve((int)numMembers, (int)numBooks);
+}
+
+// Function to read book data from a file and add it to the system, skipping books already in it;
+// columns receives the book every line of the file stands for
+int readBookFile(Session* s, string bookFile, vector<int>& columns){
 
     ifstream inputfile;
 
@@ -418,6 +798,7 @@ int readBookFile(Session* s, string bookFile ){
     string line;
     string author, title;
     int numBook = 0;
+    int duplicates = 0;
     int year = 1729;
 
 
@@ -430,7 +811,7 @@ int readBookFile(Session* s, string bookFile ){
 
 
             if(indicator == 0){
-                author = line;
+                author = word;
 
             }
             else if(indicator == 1){
@@ -440,8 +821,18 @@ int readBookFile(Session* s, string bookFile ){
             else if(indicator == 2){
                 // cout<<word<<endl;
                 year = stoi(word);
-                s->addBook(author, title, year);
-                numBook++;
+
+                // A book with the same author, title and year only keeps its first line
+                int book = s->findBook(author, title, year);
+                if(book < 0){
+                    s->addBook(author, title, year);
+                    book = s->getNumBooks() - 1;
+                    numBook++;
+                }
+                else{
+                    duplicates++;
+                }
+                columns.push_back(book);
 
             }
             indicator = (indicator+1)%3;
@@ -452,52 +843,122 @@ int readBookFile(Session* s, string bookFile ){
     }
 
     inputfile.close();
+    if(duplicates > 0){
+        cout<<"Skipped "<<duplicates<<" duplicate books in "<<bookFile<<"\n";
+    }
     return numBook;
 }
 
-// Function to read rating data from a file and add it to the system
-int readRatingFile(Session* s, string ratingFile){
-
-    ifstream inputfile;
-    inputfile.open(ratingFile);
+// Function to read rating data from a file and add it to the system, rating column j going to book columns[j]
+// (stats, if given, receives the read statistics)
+int readRatingFile(Session* s, string ratingFile, const vector<int>& columns, LoadStats* stats = nullptr,
+                   bool* complete = nullptr){
 
-    if(!inputfile){
+    if(complete){
+        *complete = false;
+    }
+    RatingFileReader reader((int)columns.size());
+    if(!reader.open(ratingFile)){
         cout<<"Error opening rating File.\n";
         return 0;
     }
 
+    // Every parsed chunk goes in with one bulk step: names as pointers into the mapped file, and the
+    // non-zero ratings as rows. Rebuilding the similarity cache once at the end is cheaper than updating
+    // it per rating.
+    s->ratings->setSimilarityCache(false);
+    bool ok = reader.read([&](RatingChunk& chunk){
+        s->addRatedMembers(chunk, columns);
+    }, reader.worthSplitting() ? s->ratings->getPool() : nullptr);
+    s->ratings->setSimilarityCache(SIMILARITY_CACHE);
+    if(!ok){
+        cout<<"Error in rating file "<<ratingFile<<", "<<reader.getError()<<"\n";
+    }
+    if(complete){
+        *complete = ok;
+    }
+    if(stats){
+        *stats = reader.getStats();
+    }
+    return reader.getStats().members;
+}
 
-    string member;
-    string line;
-    int rating;
-    int indicator = 0;
-    int numMember = 0;
-    while(getline(inputfile, line)){
-        stringstream ss(line);
-        if(indicator == 0){
-            member = line;
-            s->addMember(member);
-            numMember++;
-        }
-        else{
-            int bookIndex = 0;
+// Function to convert a pair of text files into a snapshot file; nothing is written unless both files
+// were read in full
+int convertToSnapshot(string bookFile, string ratingFile, string snapshotFile){
+    Session session;
+    session.setAdminLogIn();
+    presizeSession(&session, bookFile, ratingFile);
+    vector<int> columns;
+    int numBook = readBookFile(&session, bookFile, columns);
+    if(numBook == 0){
+        cout<<"No books read from "<<bookFile<<", nothing written.\n";
+        return 1;
+    }
+    bool complete;
+    int numMember = readRatingFile(&session, ratingFile, columns, nullptr, &complete);
+    if(!complete){
+        cout<<"Ratings not read in full, nothing written.\n";
+        return 1;
+    }
+    session.unsetAdminLogIn();
+    if(!session.writeSnapshot(snapshotFile)){
+        cout<<"Error writing snapshot file "<<snapshotFile<<".\n";
+        return 1;
+    }
+    cout<<"Wrote "<<numBook<<" books and "<<numMember<<" members to "<<snapshotFile<<"\n";
+    return 0;
+}
 
-            while(ss >> rating){
-                s->addRating(numMember-1, bookIndex, rating);
-                bookIndex++;
-            }
+// Function to merge another catalog (a books file and its ratings file) into the session: books already
+// in it keep their ISBN and take the ratings of their column, members are matched by name, and only
+// the books and members that are new are added
+void mergeCatalog(Session* s, string bookFile, string ratingFile){
+    int membersBefore = s->getNumMembers();
+    vector<int> columns;
+    int newBooks = readBookFile(s, bookFile, columns);
 
+    RatingFileReader reader((int)columns.size());
+    if(!reader.open(ratingFile)){
+        cout<<"Error opening rating File.\n";
+        return;
+    }
+    vector<int> members;
+    s->ratings->setSimilarityCache(false);
+    bool ok = reader.read([&](RatingChunk& chunk){
+
+        // Members already in the session keep their rows, so every rating goes in one at a time
+        for(int m = 0 ; m<(int)chunk.names.size() ; m++){
+            int account = s->memRecord->findMember(chunk.names[m], chunk.nameLengths[m]);
+            if(account < 0){
+                s->addMember(PooledString(chunk.names[m], chunk.nameLengths[m]));
+                account = s->getNumMembers() - 1;
+            }
+            members.push_back(account);
+            for(uint64_t k = chunk.rowStart[m] ; k<chunk.rowStart[m + 1] ; k++){
+                s->addRating(account, columns[chunk.bookIds[k]], chunk.values[k]);
+            }
         }
-        indicator = (indicator + 1) % 2;
-        // cin.ignore();
+    }, reader.worthSplitting() ? s->ratings->getPool() : nullptr);
+    s->ratings->setSimilarityCache(SIMILARITY_CACHE);
+    if(!ok){
+        cout<<"Error in rating file "<<ratingFile<<", "<<reader.getError()<<"\n";
     }
-    inputfile.close();
-    return numMember;
+    cout<<"Merged "<<columns.size()<<" books ("<<newBooks<<" new) and ";
+    cout<<members.size()<<" members ("<<s->getNumMembers() - membersBefore<<" new) with ";
+    cout<<reader.getStats().ratings<<" ratings\n";
 }
 
 // Main function
-int main(){
+int main(int argc, char** argv){
 
+    // "p1x --convert books ratings snapshot" only converts the text files and exits
+    if(argc == 5 && string(argv[1]) == "--convert"){
+        return convertToSnapshot(argv[2], argv[3], argv[4]);
+    }
+
+    // "p1x --merge books ratings" loads the library as usual, merges another catalog into it and exits
+    bool merging = argc == 4 && string(argv[1]) == "--merge";
 
     // Creating a new session
     Session* currentSession = new Session();
@@ -513,10 +974,20 @@ int main(){
     string bookFile;
     string ratingFile;
 
+    // A snapshot left by the last run is mapped and used instead of the text files
+    Snapshot snap;
+    string snapError;
+    bool haveSnapshot = snap.open(SNAPSHOT_FILE, snapError);
+    ifstream probe(SNAPSHOT_FILE);
+    if(!haveSnapshot && probe){
+        cout<<"Ignoring snapshot: "<<snapError<<"\n\n";
+    }
+    probe.close();
+
     // Checking if default files exist, if not, prompting user for file paths
     ifstream inputFile;
-    inputFile.open("books-updated.txt");
-    if(!inputFile){
+    inputFile.open(BOOK_TEXT_FILE);
+    if(!inputFile && !haveSnapshot){
 
         cout<<"Enter file path to books file: ";
         cin>>bookFile;
@@ -528,21 +999,90 @@ int main(){
 
     }
     else{
-        bookFile = "books-updated.txt";
-        ratingFile = "ratings-updated.txt";
+        bookFile = BOOK_TEXT_FILE;
+        ratingFile = RATING_TEXT_FILE;
     }
     inputFile.close();
 
-    // Setting admin login status, reading data from files, and unsetting admin login status
+    // Setting admin login status, reading data from the snapshot or the files, and unsetting admin login status
     currentSession->setAdminLogIn();
-    int numBook = readBookFile(currentSession, bookFile);
-    int numMember = readRatingFile(currentSession, ratingFile);
+    int numBook, numMember;
+    LoadStats ratingStats;
+    if(haveSnapshot){
+        // The string pool keeps reading the snapshot's strings in place, so it stays mapped until the end
+        currentSession->loadSnapshot(snap);
+
+        // The text files are saved after every snapshot, so only later changes are missing from them
+        if(!modifiedBefore(RATING_TEXT_FILE, SNAPSHOT_FILE)){
+            currentSession->ratings->clearDirty();
+        }
+        numBook = currentSession->getNumBooks();
+        numMember = currentSession->getNumMembers();
+    }
+    else{
+        presizeSession(currentSession, bookFile, ratingFile);
+        vector<int> columns;
+        numBook = readBookFile(currentSession, bookFile, columns);
+        numMember = readRatingFile(currentSession, ratingFile, columns, &ratingStats);
+    }
+
+    // Changes made since the snapshot was written are replayed from the log, which records every change from now on.
+    // The log only follows a snapshot: text files may hold another library, so a log found next to them is emptied.
+    EventLog* eventLog = new EventLog();
+    string logError;
+    if(eventLog->open(EVENT_LOG_FILE, logError)){
+        if(haveSnapshot){
+            int applied = currentSession->replayLog(*eventLog);
+            if(applied > 0){
+                cout<<"Applied "<<applied<<" changes from "<<EVENT_LOG_FILE<<"\n";
+                numBook = currentSession->getNumBooks();
+                numMember = currentSession->getNumMembers();
+            }
+        }
+        else{
+            if(eventLog->size() > (long long)strlen(EVENT_LOG_MAGIC)){
+                cout<<"Ignoring "<<EVENT_LOG_FILE<<": there is no snapshot for its changes to follow.\n";
+            }
+            eventLog->reset();
+        }
+        currentSession->eventLog = eventLog;
+
+        // Data read from text files gets a snapshot right away, so the log has something to follow
+        if(!haveSnapshot){
+            currentSession->checkpoint();
+        }
+    }
+    else{
+        cout<<"Changes will not be saved: "<<logError<<"\n";
+    }
+
+    // A merge is logged like any other change and then folded into a new snapshot
+    if(merging){
+        mergeCatalog(currentSession, argv[2], argv[3]);
+        currentSession->commitLog();
+        currentSession->checkpoint();
+        eventLog->close();
+        return 0;
+    }
     currentSession->unsetAdminLogIn();
 
+    // The book-to-book model is kept next to the ratings it is built from
+    string itemModelFile = besideFile(haveSnapshot ? SNAPSHOT_FILE : ratingFile, ITEM_MODEL_FILE);
+    currentSession->loadItemModel(itemModelFile);
+    currentSession->buildSearchIndex();
+
 
     // Outputting the number of books and members read from files
     cout<<"# of books: "<<numBook<<"\n";
     cout<<"# of members: "<<numMember<<"\n";
+    if(ratingStats.bytes > 0){
+        cout<<"Read "<<ratingStats.ratings<<" ratings from "<<ratingStats.lines<<" lines at ";
+        cout<<ratingStats.megabytesPerSecond()<<" MB/s\n";
+    }
+    if(LSH_TABLES > 0){
+        cout<<"Approximate search recall@1: ";
+        cout<<currentSession->ratings->recallAtOne(numMember, LSH_RECALL_SAMPLES)<<"\n";
+    }
 
     cout<<"\n\n";
 
@@ -550,6 +1090,7 @@ int main(){
     bool quit = 0;
 
     while(!quit){
+        currentSession->commitLog();
         int option = showMainMenu();
 
         // Handling user input based on selected option
@@ -570,10 +1111,11 @@ int main(){
             PromtlogIN(currentSession);
             bool loggedIN = 1;
             while(loggedIN){
+                currentSession->commitLog();
                 int choice = showLogInMenu();
 
-                while(!(choice >=1 && choice <= 6)){
-                    cout<<"Please enter a valid option between 1 and 6\n\n";
+                while(!(choice >=1 && choice <= 9)){
+                    cout<<"Please enter a valid option between 1 and 9\n\n";
                     choice = showLogInMenu();
                 }
 
@@ -599,6 +1141,15 @@ int main(){
                     loggedIN = 0;
                     continue;
                 }
+                else if(choice == 7){
+                    PromttopPicks(currentSession);
+                }
+                else if(choice == 8){
+                    PromtsimilarBooks(currentSession);
+                }
+                else if(choice == 9){
+                    PromtsearchBooks(currentSession);
+                }
 
 
             }
@@ -612,9 +1163,11 @@ int main(){
 
     }
 
-    // Writing book and rating data back to files before exiting
-    currentSession->writeBookFile("books-updated.txt");
-    currentSession->writeRatingsFile("ratings-updated.txt");
+    // Everything changed is already in the log, so only the last group and the changed rows need writing
+    currentSession->commitLog();
+    currentSession->saveTextFiles();
+    eventLog->close();
+    currentSession->saveItemModel(itemModelFile);
 
 
     return 0;